@@ -0,0 +1,352 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <type_traits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+#include <sys/resource.h>
+
+#include "../graph/stats.h"
+
+// deterministic random numbers, identical on every platform (SplitMix64)
+class rng {
+public:
+	explicit rng(std::uint64_t seed) : _s(seed) { }
+
+	std::uint64_t next() {
+		std::uint64_t z = (_s += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	// uniform in [0, n)
+	std::uint64_t below(std::uint64_t n) {
+		return (std::uint64_t)(((unsigned __int128)next() * n) >> 64);
+	}
+
+	// uniform in [0, 1)
+	double real() {
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+private:
+	std::uint64_t _s;
+};
+
+// generated graph on vertices 0..n-1, costs are empty when unweighted
+struct edge_list {
+	std::string name;
+	std::size_t n;
+	std::vector< std::pair<std::uint32_t, std::uint32_t> > edges;
+	std::vector<double> costs;
+
+	void add(std::uint32_t v, std::uint32_t w) {
+		edges.emplace_back(v, w);
+	}
+
+	// random integer costs in [1, hi] for every edge
+	void weigh(rng &r, std::uint64_t hi = 100) {
+		costs.resize(edges.size());
+		for (auto &c : costs) {
+			c = double(1 + r.below(hi));
+		}
+	}
+};
+
+// relabel vertices by a random permutation so ids carry no locality
+inline void shuffle(edge_list &L, rng &r) {
+	std::vector<std::uint32_t> p(L.n);
+	for (std::uint32_t i = 0; i < L.n; i++) {
+		p[i] = i;
+	}
+	for (std::size_t i = L.n; i > 1; i--) {
+		std::swap(p[i-1], p[r.below(i)]);
+	}
+	for (auto &e : L.edges) {
+		e.first = p[e.first];
+		e.second = p[e.second];
+	}
+}
+
+// R-MAT (Kronecker) graph with 2^scale vertices and factor*2^scale edges,
+// Graph500 quadrant probabilities
+inline edge_list rmat(unsigned scale, std::size_t factor, std::uint64_t seed,
+	double a = 0.57, double b = 0.19, double c = 0.19) {
+	rng r(seed);
+	edge_list L;
+	L.name = "rmat";
+	L.n = std::size_t(1) << scale;
+	L.edges.reserve(factor*L.n);
+	for (std::size_t i = 0; i < factor*L.n; i++) {
+		std::uint32_t v(0), w(0);
+		for (unsigned k = 0; k < scale; k++) {
+			double x = r.real();
+			v = 2*v + (x >= a + b);
+			w = 2*w + ((x >= a && x < a + b) || x >= a + b + c);
+		}
+		L.add(v, w);
+	}
+	shuffle(L, r);
+	return L;
+}
+
+// Erdos-Renyi G(n, m), optionally over a random spanning tree so the graph
+// is connected (and every vertex reachable from 0 when directed)
+inline edge_list erdos_renyi(std::size_t n, std::size_t m, std::uint64_t seed, bool connected = false) {
+	rng r(seed);
+	edge_list L;
+	L.name = connected ? "er_connected" : "er";
+	L.n = n;
+	L.edges.reserve(m + n);
+	if (connected) {
+		for (std::uint32_t v = 1; v < n; v++) {
+			L.add(r.below(v), v);
+		}
+	}
+	for (std::size_t i = 0; i < m; i++) {
+		L.add(r.below(n), r.below(n));
+	}
+	return L;
+}
+
+// rows x cols grid, road like when some edges are dropped and a few long
+// shortcuts are added; a torus (wrap) has every degree even
+inline edge_list grid(std::size_t rows, std::size_t cols, std::uint64_t seed,
+	bool wrap = false, double drop = 0.0, double shortcuts = 0.0) {
+	rng r(seed);
+	edge_list L;
+	L.name = wrap ? "torus" : (drop > 0.0 || shortcuts > 0.0 ? "road" : "grid");
+	L.n = rows*cols;
+	for (std::size_t i = 0; i < rows; i++) {
+		for (std::size_t j = 0; j < cols; j++) {
+			std::uint32_t v = i*cols + j;
+			if ((wrap || j + 1 < cols) && !(r.real() < drop)) {
+				L.add(v, i*cols + (j + 1)%cols);
+			}
+			if ((wrap || i + 1 < rows) && !(r.real() < drop)) {
+				L.add(v, ((i + 1)%rows)*cols + j);
+			}
+		}
+	}
+	for (std::size_t k = 0; k < shortcuts*L.n; k++) {
+		L.add(r.below(L.n), r.below(L.n));
+	}
+	return L;
+}
+
+// random DAG with edges from lower to higher rank, rank 0 reaches every
+// vertex through a spanning tree
+inline edge_list dag(std::size_t n, std::size_t m, std::uint64_t seed) {
+	rng r(seed);
+	edge_list L;
+	L.name = "dag";
+	L.n = n;
+	L.edges.reserve(m + n);
+	for (std::uint32_t v = 1; v < n; v++) {
+		L.add(r.below(v), v);
+	}
+	for (std::size_t i = 0; n > 1 && i < m; i++) {
+		std::uint32_t v = r.below(n), w = r.below(n - 1);
+		w += (w >= v);
+		L.add(std::min(v, w), std::max(v, w));
+	}
+	return L;
+}
+
+// layered flow network, source 0 and sink 1, layers of width vertices,
+// each vertex has degree arcs into the next layer, capacities in [1, 100]
+inline edge_list layered(std::size_t layers, std::size_t width, std::size_t degree, std::uint64_t seed) {
+	rng r(seed);
+	edge_list L;
+	L.name = "layered";
+	L.n = 2 + layers*width;
+	auto at = [width](std::size_t l, std::size_t i) { return std::uint32_t(2 + l*width + i); };
+	for (std::size_t i = 0; i < width; i++) {
+		L.add(0, at(0, i));
+		L.add(at(layers - 1, i), 1);
+	}
+	for (std::size_t l = 0; l + 1 < layers; l++) {
+		for (std::size_t i = 0; i < width; i++) {
+			for (std::size_t k = 0; k < degree; k++) {
+				L.add(at(l, i), at(l + 1, r.below(width)));
+			}
+		}
+	}
+	L.weigh(r);
+	return L;
+}
+
+// write L in the text format read by operator >> of the graph classes
+inline void write_text(std::ostream &os, const edge_list &L) {
+	os << L.n << " " << L.edges.size() << "\n";
+	for (std::size_t v = 0; v < L.n; v++) {
+		os << v << (v + 1 < L.n ? " " : "\n");
+	}
+	for (std::size_t i = 0; i < L.edges.size(); i++) {
+		os << L.edges[i].first << " " << L.edges[i].second;
+		if (!L.costs.empty()) {
+			os << " " << L.costs[i];
+		}
+		os << "\n";
+	}
+}
+
+// fill graph class G with L, costs are passed to addEdge when it takes one
+template <class G, class = void>
+struct takes_cost : std::false_type { };
+
+template <class G>
+struct takes_cost<G, std::void_t<decltype(std::declval<G&>().addEdge(0, 0, 0.0))> > : std::true_type { };
+
+template <class G>
+void fill(G &g, const edge_list &L, std::size_t skip = 0) {
+	for (std::size_t v = skip; v < L.n; v++) {
+		g.addVertex(v);
+	}
+	for (std::size_t i = 0; i < L.edges.size(); i++) {
+		if constexpr (takes_cost<G>::value) {
+			assert(!L.costs.empty());
+			g.addEdge(L.edges[i].first, L.edges[i].second, L.costs[i]);
+		} else {
+			g.addEdge(L.edges[i].first, L.edges[i].second);
+		}
+	}
+}
+
+// peak resident set size in KiB since the last reset_peak_rss()
+inline std::size_t peak_rss() {
+	std::ifstream is("/proc/self/status");
+	std::string line;
+	while (std::getline(is, line)) {
+		if (line.compare(0, 6, "VmHWM:") == 0) {
+			return std::strtoull(line.c_str() + 6, nullptr, 10);
+		}
+	}
+	struct rusage u;
+	getrusage(RUSAGE_SELF, &u);
+	return u.ru_maxrss;
+}
+
+// start a new peak at the current resident size (Linux only, otherwise
+// peak_rss() stays the process peak)
+inline void reset_peak_rss() {
+	std::ofstream os("/proc/self/clear_refs");
+	os << "5";
+}
+
+// one timed run of an algorithm on a generated graph
+struct result {
+	std::string suite, algorithm, generator;
+	std::size_t n, m, repeats;
+	double seconds;				// best wall time of the repeats
+	std::size_t rss;			// KiB
+	std::string stats;			// JSON of all repeats, when built with GRAPH_STATS
+};
+
+// collects results and writes them as JSON or CSV
+class bench {
+public:
+	// command line: [--csv] [--from k] [--to k] [--repeat r], sizes are
+	// about 2^k vertices
+	bench(const std::string &suite, int argc, char **argv)
+		: _suite(suite), _csv(false), _from(8), _to(14), _repeat(3) {
+		for (int i = 1; i < argc; i++) {
+			std::string a = argv[i];
+			if (a == "--csv") {
+				_csv = true;
+			} else if (a == "--json") {
+				_csv = false;
+			} else if (a == "--from" && i + 1 < argc) {
+				_from = std::atoi(argv[++i]);
+			} else if (a == "--to" && i + 1 < argc) {
+				_to = std::atoi(argv[++i]);
+			} else if (a == "--repeat" && i + 1 < argc) {
+				_repeat = std::max(1, std::atoi(argv[++i]));
+			} else {
+				std::cerr << "usage: " << argv[0] << " [--csv|--json] [--from k] [--to k] [--repeat r]" << std::endl;
+				std::exit(1);
+			}
+		}
+	}
+
+	// size exponents to run, capped for algorithms that do not scale
+	std::vector<unsigned> scales(unsigned cap = 64) const {
+		std::vector<unsigned> ans;
+		for (unsigned k = _from; k <= std::min(_to, cap); k++) {
+			ans.push_back(k);
+		}
+		return ans;
+	}
+
+	// time f, which runs the algorithm once on a graph of n vertices and m
+	// edges that already exists
+	void time(const std::string &algorithm, const std::string &generator, std::size_t n, std::size_t m,
+		const std::function<void()> &f) {
+		result r{_suite, algorithm, generator, n, m, std::size_t(_repeat), 0.0, 0, ""};
+		reset_peak_rss();
+		if (stats::enabled) {
+			stats::reset();
+		}
+		for (unsigned i = 0; i < _repeat; i++) {
+			auto start = std::chrono::steady_clock::now();
+			f();
+			double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			r.seconds = (i == 0) ? s : std::min(r.seconds, s);
+		}
+		r.rss = peak_rss();
+		if (stats::enabled) {
+			r.stats = stats::json();
+		}
+		_results.push_back(r);
+		std::cerr << algorithm << " " << generator << " n=" << n << " m=" << m << " " << r.seconds << "s" << std::endl;
+	}
+
+	// write every result collected so far
+	void report(std::ostream &os = std::cout) const {
+		if (_csv) {
+			os << "suite,algorithm,generator,n,m,repeats,seconds,edges_per_sec,peak_rss_kib\n";
+		} else {
+			os << "[\n";
+		}
+		for (std::size_t i = 0; i < _results.size(); i++) {
+			const result &r = _results[i];
+			double eps = r.seconds > 0.0 ? r.m / r.seconds : 0.0;
+			if (_csv) {
+				os << r.suite << "," << r.algorithm << "," << r.generator << "," << r.n << "," << r.m << ","
+					<< r.repeats << "," << r.seconds << "," << eps << "," << r.rss << "\n";
+			} else {
+				os << "  {\"suite\": \"" << r.suite << "\", \"algorithm\": \"" << r.algorithm
+					<< "\", \"generator\": \"" << r.generator << "\", \"n\": " << r.n << ", \"m\": " << r.m
+					<< ", \"repeats\": " << r.repeats << ", \"seconds\": " << r.seconds
+					<< ", \"edges_per_sec\": " << eps << ", \"peak_rss_kib\": " << r.rss
+					<< (r.stats.empty() ? "" : ", \"stats\": " + r.stats) << "}"
+					<< (i + 1 < _results.size() ? "," : "") << "\n";
+			}
+		}
+		if (!_csv) {
+			os << "]\n";
+		}
+	}
+
+private:
+	std::string _suite;
+	bool _csv;
+	unsigned _from, _to, _repeat;
+	std::vector<result> _results;
+
+};
+
+#endif // BENCH_H
@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cassert>
+
+#include "../digraph/digraph.h"
+#include "../digraph/dfs.h"
+#include "../digraph/tscc.h"
+#include "../digraph/pscc.h"
+#include "../digraph/topo.h"
+#include "../digraph/reach.h"
+#include "../digraph/closure.h"
+#include "../digraph/iscc.h"
+#include "../graph/csr.h"
+#include "../graph/packed.h"
+#include "../graph/reorder.h"
+#include "../graph/binary.h"
+#include "../network/network.h"
+#include "../flownetwork/flownetwork.h"
+#include "bench.h"
+
+using namespace std;
+
+// largest size exponents of the algorithms that do not scale
+const unsigned bellman_ford_cap = 10;		// O(nm) with a copy per round
+const unsigned floyd_warshall_cap = 7;		// O(n^3) on cost maps
+const unsigned max_flow_cap = 10;			// copies a flow per augmenting path
+const unsigned closure_cap = 15;			// dense rows take k^2/16 bytes
+const unsigned sparse_closure_cap = 13;		// merges copy every id of a row
+
+// random pairs asked of each reachability index
+const size_t reach_queries = 1 << 16;
+
+// directed suite: DFS, DAG checks, incremental topological order, TSCC,
+// PSCC, incremental SCCs, Kscc (also with in edges kept), reachability
+// queries, transitive closure, shortest paths (also on reordered
+// snapshots) and max flow
+// usage: bench_digraph [--csv|--json] [--from k] [--to k] [--repeat r]
+int main(int argc, char **argv) {
+	bench B("digraph", argc, argv);
+
+	for (unsigned k : B.scales()) {
+		size_t n = size_t(1) << k;
+
+		for (auto &L : {rmat(k, 8, k), erdos_renyi(n, 8*n, k), dag(n, 8*n, k)}) {
+			digraph<int> D;
+			fill(D, L);
+			digraph<int, small_adjacency> E;
+			fill(E, L);
+			csr<int> S(D);
+
+			B.time("DFS", L.name, D.n(), D.m(), [&] { DFS<int> d(D); });
+			B.time("DFS/small", L.name, E.n(), E.m(), [&] { DFS<int> d(E); });
+			B.time("DFS/csr", L.name, S.n(), S.m(), [&] { DFS<int> d(S); });
+
+			// visitor searches, isDAG stops at the first back edge
+			B.time("isDAG", L.name, D.n(), D.m(), [&] { D.isDAG(); });
+			B.time("isDAG/csr", L.name, S.n(), S.m(), [&] { cycle_visitor<csr<int>::Id> c; depth_first(S, c); });
+			if (D.isDAG()) {
+				B.time("ts", L.name, D.n(), D.m(), [&] { D.ts(); });
+			}
+			B.time("TSCC", L.name, D.n(), D.m(), [&] { TSCC<int> t(D); });
+			B.time("TSCC/small", L.name, E.n(), E.m(), [&] { TSCC<int> t(E); });
+			B.time("TSCC/csr", L.name, S.n(), S.m(), [&] { TSCC<int> t(S); });
+			B.time("PSCC", L.name, S.n(), S.m(), [&] { PSCC<int> p(S); });
+			packed_csr<int> P(S);
+			B.time("TSCC/packed", L.name, P.n(), P.m(), [&] { TSCC<int> t(P); });
+			csr<int> R = reorder(S, rcm_order(S));
+			B.time("TSCC/csr+rcm", L.name, R.n(), R.m(), [&] { TSCC<int> t(R); });
+			B.time("Kscc", L.name, D.n(), D.m(), [&] { D.Kscc(); });
+
+			// reachability index, then random queries against it
+			B.time("reachability", L.name, S.n(), S.m(), [&] { reachability<int> I(S); });
+			reachability<int> I(S);
+			rng q(k);
+			std::vector< std::pair<int, int> > queries(reach_queries);
+			for (auto &p : queries) {
+				p = std::make_pair(int(q.below(n)), int(q.below(n)));
+			}
+			size_t hits(0);
+			B.time("reaches", L.name, queries.size(), queries.size(), [&] {
+				for (auto &p : queries) {
+					hits += I.reaches(p.first, p.second);
+				}
+			});
+
+			// full transitive closure over the condensation, both row kinds
+			if (k <= closure_cap) {
+				B.time("closure/dense", L.name, S.n(), S.m(), [&] { transitive_closure<int> T(S); });
+			}
+			if (k <= sparse_closure_cap) {
+				B.time("closure/sparse", L.name, S.n(), S.m(), [&] { transitive_closure<int, sparse_rows> T(S); });
+			}
+
+			// in edges kept in sync, indeg of a plain digraph scans every vertex
+			B.time("build/bidirectional", L.name, D.n(), D.m(), [&] { digraph<int, bidirectional<>> H; fill(H, L); });
+			digraph<int, bidirectional<>> H;
+			fill(H, L);
+			B.time("Kscc/bidirectional", L.name, H.n(), H.m(), [&] { H.Kscc(); });
+			size_t sum(0);
+			B.time("indeg/bidirectional", L.name, H.n(), H.m(), [&] {
+				for (auto &v : H.V()) {
+					sum += H.indeg(v);
+				}
+			});
+			assert(sum % H.m() == 0);
+
+			// incremental order and components inserting every edge, ids
+			// shuffled so the insertions disagree with the order
+			edge_list M = L;
+			rng r(k);
+			shuffle(M, r);
+			if (L.name == "dag") {
+				B.time("topological_order", L.name, D.n(), D.m(), [&] { topological_order<int> T; fill(T, M); });
+			}
+			B.time("ISCC", L.name, D.n(), D.m(), [&] { ISCC<int> I; fill(I, M); });
+		}
+
+		// every vertex is reachable from 0, which Dijkstra needs
+		for (auto L : {erdos_renyi(n, 4*n, k, true), dag(n, 4*n, k)}) {
+			rng r(k);
+			L.weigh(r);
+			network<int> N;
+			fill(N, L);
+
+			B.time("Dijkstra", L.name, N.n(), N.m(), [&] { N.Dijkstra(0); });
+
+			csr<int> S(N);
+			vector<double> cost = arc_costs(S, N), rcost = cost;
+			csr<int> R = reorder(S, rcm_order(S), &rcost);
+			B.time("Dijkstra/csr", L.name, S.n(), S.m(), [&] { Dijkstra(S, cost, 0); });
+			B.time("Dijkstra/csr+rcm", L.name, R.n(), R.m(), [&] { Dijkstra(R, rcost, 0); });
+			if (k <= bellman_ford_cap) {
+				B.time("Bellman_Ford", L.name, N.n(), N.m(), [&] { N.Bellman_Ford(0); });
+			}
+			if (k <= floyd_warshall_cap) {
+				B.time("Floyd_Warshall", L.name, N.n(), N.m(), [&] { N.Floyd_Warshall(); });
+			}
+		}
+
+		if (k <= max_flow_cap) {
+			edge_list L = layered(k, max(n/k, size_t(1)), 4, k);
+			flownetwork<int> F(0, 1);
+			fill(F, L, 2);
+
+			B.time("max_flow", L.name, F.n(), F.m(), [&] { F.max_flow(); });
+		}
+	}
+
+	B.report();
+}
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "bench.h"
+
+using namespace std;
+
+// write a generated graph of about 2^k vertices in the text format
+// usage: gen rmat|er|grid|road|torus|dag|layered k [seed] [weighted]
+int main(int argc, char **argv) {
+	if (argc < 3) {
+		cerr << "usage: " << argv[0] << " rmat|er|grid|road|torus|dag|layered k [seed] [weighted]" << endl;
+		return 1;
+	}
+	string kind = argv[1];
+	unsigned k = atoi(argv[2]);
+	uint64_t seed = (argc > 3) ? strtoull(argv[3], nullptr, 10) : k;
+	bool weighted = (argc > 4 && string(argv[4]) == "weighted");
+
+	size_t n = size_t(1) << k;
+	size_t rows = size_t(1) << (k/2), cols = n/rows;
+	edge_list L;
+	if (kind == "rmat") {
+		L = rmat(k, 8, seed);
+	} else if (kind == "er") {
+		L = erdos_renyi(n, 8*n, seed);
+	} else if (kind == "grid") {
+		L = grid(rows, cols, seed);
+	} else if (kind == "road") {
+		L = grid(rows, cols, seed, false, 0.1, 0.01);
+	} else if (kind == "torus") {
+		L = grid(rows, cols, seed, true);
+	} else if (kind == "dag") {
+		L = dag(n, 8*n, seed);
+	} else if (kind == "layered") {
+		L = layered(k, max(n/k, size_t(1)), 4, seed);
+	} else {
+		cerr << "unknown generator " << kind << endl;
+		return 1;
+	}
+
+	if (weighted && L.costs.empty()) {
+		rng r(seed);
+		L.weigh(r);
+	}
+	write_text(cout, L);
+}
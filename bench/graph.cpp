@@ -0,0 +1,105 @@
+#include <iostream>
+#include <filesystem>
+#include <cassert>
+
+#include "../graph/graph.h"
+#include "../graph/bfs.h"
+#include "../graph/dfs.h"
+#include "../graph/eulerian.h"
+#include "../graph/pcc.h"
+#include "../graph/csr.h"
+#include "../graph/packed.h"
+#include "../graph/reorder.h"
+#include "../graph/binary.h"
+#include "../graph/sebfs.h"
+#include "../graph/secc.h"
+#include "../wgraph/wgraph.h"
+#include "bench.h"
+
+using namespace std;
+
+// largest size exponent of Gorder, which does sum of squared degrees work
+const unsigned gorder_cap = 14;
+
+// undirected suite: building, BFS, DFS (also on packed, reordered and
+// on disk snapshots), Eulerian and the three MSTs
+// usage: bench_graph [--csv|--json] [--from k] [--to k] [--repeat r]
+int main(int argc, char **argv) {
+	bench B("graph", argc, argv);
+
+	for (unsigned k : B.scales()) {
+		size_t n = size_t(1) << k;
+		size_t rows = size_t(1) << (k/2), cols = n/rows;
+
+		for (auto &L : {rmat(k, 8, k), erdos_renyi(n, 8*n, k), grid(rows, cols, k, false, 0.1, 0.01)}) {
+			graph<int> G;
+			fill(G, L);
+			csr<int> S(G);
+
+			B.time("build", L.name, G.n(), G.m(), [&] { graph<int> H; fill(H, L); });
+			B.time("build/small", L.name, G.n(), G.m(), [&] { graph<int, small_adjacency> H; fill(H, L); });
+
+			graph<int, small_adjacency> H;
+			fill(H, L);
+
+			B.time("BFS", L.name, G.n(), G.m(), [&] { BFS<int> b(G, 0); });
+			B.time("BFS/small", L.name, H.n(), H.m(), [&] { BFS<int> b(H, 0); });
+			B.time("BFS/csr", L.name, S.n(), S.m(), [&] { BFS<int> b(S, 0); });
+			B.time("DFS", L.name, G.n(), G.m(), [&] { DFS<int> d(G, 0); });
+			B.time("DFS/small", L.name, H.n(), H.m(), [&] { DFS<int> d(H, 0); });
+			B.time("DFS/csr", L.name, S.n(), S.m(), [&] { DFS<int> d(S, 0); });
+			packed_csr<int> P(S);
+			B.time("BFS/packed", L.name, P.n(), P.m(), [&] { BFS<int> b(P, 0); });
+			B.time("DFS/packed", L.name, P.n(), P.m(), [&] { DFS<int> d(P, 0); });
+
+			// semi external runs streaming the edges from a binary file
+			string path = (filesystem::temp_directory_path() / "bench_graph.bin").string();
+			if (save_binary(path, S, graph_kind::graph)) {
+				edge_file E;
+				E.open(path);
+				B.time("SECC", L.name, S.n(), S.m(), [&] { SECC<int> c(E); });
+				B.time("SEBFS", L.name, S.n(), S.m(), [&] { SEBFS<int> b(E, 0); });
+				filesystem::remove(path);
+			}
+
+			// the same searches on relabeled snapshots
+			vector<csr<int>::Id> rcm, gord;
+			B.time("rcm_order", L.name, S.n(), S.m(), [&] { rcm = rcm_order(S); });
+			csr<int> R = reorder(S, rcm);
+			B.time("BFS/csr+rcm", L.name, R.n(), R.m(), [&] { BFS<int> b(R, 0); });
+			B.time("DFS/csr+rcm", L.name, R.n(), R.m(), [&] { DFS<int> d(R, 0); });
+			packed_csr<int> PR(R);
+			B.time("BFS/packed+rcm", L.name, PR.n(), PR.m(), [&] { BFS<int> b(PR, 0); });
+			if (k <= gorder_cap) {
+				B.time("gorder", L.name, S.n(), S.m(), [&] { gord = gorder(S); });
+				csr<int> O = reorder(S, gord);
+				B.time("BFS/csr+gorder", L.name, O.n(), O.m(), [&] { BFS<int> b(O, 0); });
+			}
+		}
+
+		// every vertex of a torus has degree 4
+		{
+			edge_list L = grid(max(rows, size_t(3)), max(cols, size_t(3)), k, true);
+			graph<int> G;
+			fill(G, L);
+			csr<int> S(G);
+
+			B.time("Eulerian", L.name, G.n(), G.m(), [&] { Eulerian<int> e(G); });
+			B.time("Eulerian/csr", L.name, S.n(), S.m(), [&] { Eulerian<int> e(S); });
+		}
+
+		// spanning trees need connected weighted graphs
+		for (auto L : {erdos_renyi(n, 4*n, k, true), grid(rows, cols, k)}) {
+			rng r(k);
+			L.weigh(r);
+			wgraph<int> W;
+			fill(W, L);
+
+			B.time("Kruskal_MST", L.name, W.n(), W.m(), [&] { W.Kruskal_MST(); });
+			B.time("Boruvka_MST", L.name, W.n(), W.m(), [&] { W.Boruvka_MST(); });
+			B.time("Prim_MST", L.name, W.n(), W.m(), [&] { W.Prim_MST(); });
+		}
+	}
+
+	B.report();
+}
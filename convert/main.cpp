@@ -0,0 +1,51 @@
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "../graph/csr.h"
+#include "../graph/parse.h"
+#include "../graph/binary.h"
+
+using namespace std;
+
+typedef csr<string>::Id Id;
+
+// convert a text graph read from stdin to the binary format
+// usage: convert graph|digraph|wgraph|network|flownetwork out.bin < in.txt
+int main(int argc, char **argv) {
+	const char *names[] = {"graph", "digraph", "wgraph", "network", "flownetwork"};
+	if (argc != 3 || find(names, names + 5, string(argv[1])) == names + 5) {
+		cerr << "usage: " << argv[0] << " graph|digraph|wgraph|network|flownetwork out.bin < in.txt" << endl;
+		return 1;
+	}
+	graph_kind kind = graph_kind(find(names, names + 5, string(argv[1])) - names);
+
+	text_reader<string> R;
+	if (!R.read("/dev/stdin", isWeighted(kind))) {
+		cerr << "cannot parse input" << endl;
+		return 1;
+	}
+
+	// repeated edges keep the first cost in a wgraph and the last in a
+	// network, matching their addEdge
+	bool last = (kind == graph_kind::network || kind == graph_kind::flownetwork);
+	vector<double> cost;
+	csr<string> S = R.snapshot(!isUndirected(kind), isWeighted(kind) ? &cost : nullptr, last);
+
+	Id source(csr<string>::none), sink(csr<string>::none);
+	if (kind == graph_kind::flownetwork) {
+		assert(S.n() >= 2);
+		source = 0;
+		sink = 1;
+	}
+
+	if (!save_binary(argv[2], S, kind, cost, source, sink)) {
+		cerr << "cannot write " << argv[2] << endl;
+		return 1;
+	}
+
+	cout << S.n() << " vertices, " << S.m() << " edges written to " << argv[2] << endl;
+}
@@ -0,0 +1,229 @@
+#ifndef CLOSURE_H
+#define CLOSURE_H
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+
+#include "../graph/csr.h"
+#include "../graph/stats.h"
+#include "condense.h"
+
+// rows of a transitive closure over a condensation, the set of components
+// below each one; components come in ascending ids, so every successor's
+// row is complete, and successors are merged from the largest id down: one
+// reached through an earlier successor is already in the row and skipped
+//
+// a row policy has build(G), test(a, b) for b below a, each(a, f) calling
+// f(b) for every b below a, and bytes()
+
+// one bitset per component over the smaller ids only (a triangle, k^2/16
+// bytes for k components), successors merged with a word wise or
+class dense_rows {
+public:
+	typedef std::uint32_t Id;
+	typedef std::uint64_t word;
+
+	template <class Dag>
+	void build(const Dag &G) {
+		std::size_t k = G.ncc();
+		_off.assign(k + 1, 0);
+		for (std::size_t c = 0; c < k; c++) {
+			_off[c+1] = _off[c] + words(c);
+		}
+		_w.assign(_off[k], 0);
+
+		for (Id c = 0; c < k; c++) {
+			word *row = _w.data() + _off[c];
+			auto adj = G.Adj(c);
+			for (auto it = adj.end(); it != adj.begin(); ) {
+				Id x = *--it;
+				if ((row[x >> 6] >> (x & 63)) & 1) {
+					continue;
+				}
+				row[x >> 6] |= word(1) << (x & 63);
+				merge(row, _w.data() + _off[x], words(x));
+			}
+		}
+	}
+
+	// true if b is below a
+	bool test(Id a, Id b) const {
+		return b < a && ((_w[_off[a] + (b >> 6)] >> (b & 63)) & 1);
+	}
+
+	template <class F>
+	void each(Id a, F f) const {
+		for (std::size_t i = _off[a]; i < _off[a+1]; i++) {
+			for (word x = _w[i]; x != 0; x &= x - 1) {
+				f(Id(((i - _off[a]) << 6) + __builtin_ctzll(x)));
+			}
+		}
+	}
+
+	// number of components below a
+	std::size_t count(Id a) const {
+		std::size_t ans(0);
+		for (std::size_t i = _off[a]; i < _off[a+1]; i++) {
+			ans += __builtin_popcountll(_w[i]);
+		}
+		return ans;
+	}
+
+	std::size_t bytes() const {
+		return _w.size()*sizeof(word) + _off.size()*sizeof(std::size_t);
+	}
+
+private:
+	std::vector<std::size_t> _off;		// row c is words [_off[c], _off[c+1])
+	std::vector<word> _w;
+
+	// words holding the ids below c
+	static std::size_t words(std::size_t c) {
+		return (c + 63)/64;
+	}
+
+	// a |= b over n words; the rows never overlap, and four words a step
+	// are vectorized even at -O2
+	static void merge(word *__restrict a, const word *__restrict b, std::size_t n) {
+		std::size_t i(0);
+		for (; i + 4 <= n; i += 4) {
+			a[i] |= b[i];
+			a[i+1] |= b[i+1];
+			a[i+2] |= b[i+2];
+			a[i+3] |= b[i+3];
+		}
+		for (; i < n; i++) {
+			a[i] |= b[i];
+		}
+	}
+
+};
+
+// one sorted array of component ids per component, 4 bytes per reachable
+// pair, smaller than dense rows below k^2/64 pairs
+class sparse_rows {
+public:
+	typedef std::uint32_t Id;
+
+	template <class Dag>
+	void build(const Dag &G) {
+		std::size_t k = G.ncc();
+		_off.assign(1, 0);
+		_ids.clear();
+		std::vector<Id> stamp(k, std::numeric_limits<Id>::max());
+
+		for (Id c = 0; c < k; c++) {
+			std::size_t first = _ids.size();
+			auto adj = G.Adj(c);
+			for (auto it = adj.end(); it != adj.begin(); ) {
+				Id x = *--it;
+				if (stamp[x] == c) {
+					continue;
+				}
+				stamp[x] = c;
+				_ids.push_back(x);
+				for (std::size_t i = _off[x]; i < _off[x+1]; i++) {
+					Id y = _ids[i];
+					if (stamp[y] != c) {
+						stamp[y] = c;
+						_ids.push_back(y);
+					}
+				}
+			}
+			std::sort(_ids.begin() + first, _ids.end());
+			_off.push_back(_ids.size());
+		}
+		_ids.shrink_to_fit();
+	}
+
+	// true if b is below a
+	bool test(Id a, Id b) const {
+		return b < a && std::binary_search(_ids.begin() + _off[a], _ids.begin() + _off[a+1], b);
+	}
+
+	template <class F>
+	void each(Id a, F f) const {
+		for (std::size_t i = _off[a]; i < _off[a+1]; i++) {
+			f(_ids[i]);
+		}
+	}
+
+	// number of components below a
+	std::size_t count(Id a) const {
+		return _off[a+1] - _off[a];
+	}
+
+	std::size_t bytes() const {
+		return _ids.size()*sizeof(Id) + _off.size()*sizeof(std::size_t);
+	}
+
+private:
+	std::vector<std::size_t> _off;		// row c is ids [_off[c], _off[c+1])
+	std::vector<Id> _ids;
+
+};
+
+// transitive closure of a digraph, computed once over its condensation in
+// reverse topological order; Rows is dense_rows or sparse_rows
+//
+//   transitive_closure<int> T(D);
+//   T.reaches(u, v);        // O(1) dense, O(log) sparse
+//   T.reachable(u);         // every vertex with a path from u
+template <class Vertex, class Rows = dense_rows>
+class transitive_closure {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	template <class Adjacency>
+	explicit transitive_closure(const digraph<Vertex, Adjacency> &D) : _G(D) {
+		STATS_PHASE("transitive_closure");
+		_R.build(_G);
+	}
+
+	explicit transitive_closure(const csr<Vertex> &S) : _G(S) {
+		STATS_PHASE("transitive_closure");
+		_R.build(_G);
+	}
+
+	// number of strongly connected components
+	std::size_t ncc() const {
+		return _G.ncc();
+	}
+
+	// bytes held by the rows
+	std::size_t bytes() const {
+		return _R.bytes();
+	}
+
+	// return true if there is a path from u to v
+	bool reaches(const Vertex &u, const Vertex &v) const {
+		Id a = _G.component(u), b = _G.component(v);
+		return a == b || _R.test(a, b);
+	}
+
+	// return number of vertices with a path from u, u included
+	std::size_t count(const Vertex &u) const {
+		Id a = _G.component(u);
+		std::size_t ans = _G.members(a).size();
+		_R.each(a, [&](Id b) { ans += _G.members(b).size(); });
+		return ans;
+	}
+
+	// return every vertex with a path from u, u included
+	std::vector<Vertex> reachable(const Vertex &u) const {
+		Id a = _G.component(u);
+		std::vector<Vertex> ans(_G.members(a).begin(), _G.members(a).end());
+		_R.each(a, [&](Id b) { ans.insert(ans.end(), _G.members(b).begin(), _G.members(b).end()); });
+		return ans;
+	}
+
+private:
+	condensation<Vertex> _G;
+	Rows _R;
+
+};
+
+#endif // CLOSURE_H
@@ -0,0 +1,130 @@
+#ifndef CONDENSE_H
+#define CONDENSE_H
+
+#include <unordered_map>
+#include <algorithm>
+#include <vector>
+#include <cassert>
+
+#include "../graph/csr.h"
+#include "../graph/view.h"
+#include "../graph/stats.h"
+#include "tscc.h"
+
+// DAG of the strongly connected components of a digraph, numbered by
+// Tarjan in reverse topological order: every edge goes from a component
+// to one with a smaller id, so ascending ids visit sinks first
+//
+//   condensation<int> C(D);
+//   for (auto c : C.Adj(C.component(v))) { ... }
+//
+// components and their neighbor lists are csr arrays of ids, each list
+// sorted and without repeats
+template <class Vertex>
+class condensation {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	template <class Adjacency>
+	explicit condensation(const digraph<Vertex, Adjacency> &D) : condensation(csr<Vertex>(D)) { }
+
+	explicit condensation(const csr<Vertex> &S) {
+		STATS_PHASE("condensation");
+		TSCC<Vertex> T(S);
+		std::size_t k = T.ncc();
+
+		std::vector<Id> comp(S.n());
+		_C.reserve(S.n());
+		for (auto &p : T.components()) {
+			Id c = Id(p.second);
+			comp[S.id(p.first)] = c;
+			_C.emplace(p.first, c);
+		}
+
+		// members grouped by component
+		_moff.assign(k + 1, 0);
+		for (Id v = 0; v < S.n(); v++) {
+			_moff[comp[v] + 1]++;
+		}
+		for (std::size_t c = 0; c < k; c++) {
+			_moff[c+1] += _moff[c];
+		}
+		std::vector<std::size_t> at(_moff.begin(), _moff.end() - 1);
+		_members.resize(S.n());
+		for (Id v = 0; v < S.n(); v++) {
+			_members[at[comp[v]]++] = S.vertex(v);
+		}
+
+		// arcs between components, counted then placed, then each list
+		// sorted and made unique
+		_off.assign(k + 1, 0);
+		for (Id v = 0; v < S.n(); v++) {
+			for (Id w : S.Adj(v)) {
+				if (comp[v] != comp[w]) {
+					_off[comp[v] + 1]++;
+				}
+			}
+		}
+		for (std::size_t c = 0; c < k; c++) {
+			_off[c+1] += _off[c];
+		}
+		_adj.resize(_off[k]);
+		at.assign(_off.begin(), _off.end() - 1);
+		for (Id v = 0; v < S.n(); v++) {
+			for (Id w : S.Adj(v)) {
+				if (comp[v] != comp[w]) {
+					_adj[at[comp[v]]++] = comp[w];
+				}
+			}
+		}
+		std::size_t m(0);
+		for (std::size_t c = 0; c < k; c++) {
+			auto first = _adj.begin() + _off[c], last = _adj.begin() + _off[c+1];
+			std::sort(first, last);
+			last = std::unique(first, last);
+			_off[c] = m;
+			m = std::move(first, last, _adj.begin() + m) - _adj.begin();
+		}
+		_off[k] = m;
+		_adj.resize(m);
+		_adj.shrink_to_fit();
+	}
+
+	// number of components
+	std::size_t ncc() const {
+		return _off.size() - 1;
+	}
+
+	// number of edges between components
+	std::size_t m() const {
+		return _adj.size();
+	}
+
+	// component id of v
+	Id component(const Vertex &v) const {
+		assert(_C.count(v));
+		return _C.at(v);
+	}
+
+	// components with an edge from c, all smaller than c
+	array_view<Id> Adj(Id c) const {
+		assert(c < ncc());
+		return array_view<Id>(_adj.data() + _off[c], _off[c+1] - _off[c]);
+	}
+
+	// vertices of component c
+	array_view<Vertex> members(Id c) const {
+		assert(c < ncc());
+		return array_view<Vertex>(_members.data() + _moff[c], _moff[c+1] - _moff[c]);
+	}
+
+private:
+	std::unordered_map<Vertex, Id> _C;		// vertex -> component
+	std::vector<std::size_t> _off;			// neighbor lists of the components
+	std::vector<Id> _adj;
+	std::vector<std::size_t> _moff;			// members of the components
+	std::vector<Vertex> _members;
+
+};
+
+#endif // CONDENSE_H
@@ -2,26 +2,55 @@
 #define DFS_H
 
 #include <unordered_map>
+#include <memory_resource>
 #include <list>
+#include <vector>
+#include <limits>
 
-template <class Vertex> class digraph;
+#include "../graph/arena.h"
+#include "../graph/csr.h"
+#include "../graph/packed.h"
+#include "../graph/stats.h"
+#include "../graph/adjacency.h"
 
 template <class Vertex>
 class DFS {
+	template <class Set> struct Frame;
+	template <class It> struct DFrame;
+
 public:
-	DFS(const digraph<Vertex> &D, const std::list<Vertex> &V = std::list<Vertex>()) {
+	typedef typename csr<Vertex>::Id Id;
+
+	template <class Adjacency>
+	DFS(const digraph<Vertex, Adjacency> &D, const std::list<Vertex> &V = std::list<Vertex>()) {
+		STATS_PHASE("DFS");
+		traverse(D, V);
+	}
+
+	// same search on the transpose of a digraph keeping in edges
+	template <class Adjacency>
+	DFS(const transpose_view<Vertex, Adjacency> &D, const std::list<Vertex> &V = std::list<Vertex>()) {
+		STATS_PHASE("DFS/transpose");
+		traverse(D, V);
+	}
+
+	// search from the vertices of V in order, then from any unvisited one,
+	// and classify every edge of a digraph or view
+	template <class G>
+	void traverse(const G &D, const std::list<Vertex> &V) {
 		_ncc = _time = 0;
+		std::vector< Frame<typename G::VertexSet> > stack;
 
 		for (auto &v : V) {
 			if (D.isVertex(v) && _pre.count(v) == 0) {
-				dfs_one(D, v);
+				dfs_one(D, v, stack);
 				_ncc++;
 			}
 		}
 
 		for (auto &v : D.V()) {
 			if (_pre.count(v) == 0) {
-				dfs_one(D, v);
+				dfs_one(D, v, stack);
 				_ncc++;
 			}
 		}
@@ -46,37 +75,108 @@ public:
 		}
 	}
 
-	void dfs_one(const digraph<Vertex> &D, const Vertex &v) {
-		_pre[v] = _time++;
-		_C[v] = _ncc;
-		for (auto &w : D.Adj(v)) {
-			if (_pre.count(w) == 0) {
-				_P[w] = v;
-				dfs_one(D, w);
+	// iterative search, the explicit stack is reused between calls
+	template <class G, class Set>
+	void dfs_one(const G &D, const Vertex &v, std::vector< Frame<Set> > &stack) {
+		enter(D, v, stack);
+
+		while (!stack.empty()) {
+			Frame<Set> &f = stack.back();
+			if (f.next != f.end) {
+				const Vertex &w = *(f.next++);
+				STATS_ADD(dfs_edges, 1);
+				if (_pre.count(w) == 0) {
+					_P[w] = f.v;
+					enter(D, w, stack);
+				}
+			} else {
+				_post[f.v] = _time++;
+				_ts.push_front(f.v);
+				stack.pop_back();
+			}
+		}
+	}
+
+	// same search on a csr snapshot, results are translated back to vertices
+	DFS(const csr<Vertex> &D, const std::list<Vertex> &V = std::list<Vertex>()) {
+		STATS_PHASE("DFS/csr");
+		search(D, V);
+	}
+
+	// same search decoding the neighbor lists of a packed snapshot
+	DFS(const packed_csr<Vertex> &D, const std::list<Vertex> &V = std::list<Vertex>()) {
+		STATS_PHASE("DFS/packed");
+		search(D, V);
+	}
+
+	// search from the vertices of V in order, then from any unvisited one
+	template <class Snapshot>
+	void search(const Snapshot &D, const std::list<Vertex> &V) {
+		_ncc = _time = 0;
+		std::vector< DFrame<typename Snapshot::const_iterator> > stack;
+		_dpre.assign(D.n(), inf);
+		_dpost.assign(D.n(), 0);
+		_dC.assign(D.n(), 0);
+		_dP.assign(D.n(), csr<Vertex>::none);
+
+		for (auto &v : V) {
+			if (D.isVertex(v) && _dpre[D.id(v)] == inf) {
+				dfs_one(D, D.id(v), stack);
+				_ncc++;
+			}
+		}
+
+		for (Id v = 0; v < D.n(); v++) {
+			if (_dpre[v] == inf) {
+				dfs_one(D, v, stack);
+				_ncc++;
+			}
+		}
+
+		translate(D);
+	}
+
+	// iterative search, the explicit stack is reused between calls
+	template <class Snapshot, class It>
+	void dfs_one(const Snapshot &D, Id v, std::vector< DFrame<It> > &stack) {
+		enter(D, v, stack);
+
+		while (!stack.empty()) {
+			DFrame<It> &f = stack.back();
+			if (f.next != f.end) {
+				Id w = *f.next;
+				++f.next;
+				STATS_ADD(dfs_edges, 1);
+				if (_dpre[w] == inf) {
+					_dP[w] = f.v;
+					enter(D, w, stack);
+				}
+			} else {
+				_dpost[f.v] = _time++;
+				_ts.push_front(D.vertex(f.v));
+				stack.pop_back();
 			}
 		}
-		_post[v] = _time++;
-		_ts.push_front(v);
 	}
 
 	// pre times for each vertex
 	std::unordered_map<Vertex, std::size_t> pre() const {
-		return _pre;
+		return std::unordered_map<Vertex, std::size_t>(_pre.begin(), _pre.end());
 	}
 
 	// post times for each vertex
 	std::unordered_map<Vertex, std::size_t> post() const {
-		return _post;
+		return std::unordered_map<Vertex, std::size_t>(_post.begin(), _post.end());
 	}
 
 	// parents of each vertex in Depth First Tree
 	std::unordered_map<Vertex, Vertex> dfTree() const {
-		return _P;
+		return std::unordered_map<Vertex, Vertex>(_P.begin(), _P.end());
 	}
 
 	// component ids for each vertex
 	std::unordered_map<Vertex, std::size_t> components() const {
-		return _C;
+		return std::unordered_map<Vertex, std::size_t>(_C.begin(), _C.end());
 	}
 
 	// number of connected components
@@ -104,7 +204,8 @@ public:
 		return _ts;
 	}
 
-	// returns type of edge where 0: tree 1: back 2: forward 3: cross
+	// returns type of edge where 0: tree 1: back 2: forward 3: cross, a self
+	// loop is a back edge
 	int edge_type(const Vertex &v, const Vertex &w) const {
 		assert(_pre.count(v) && _pre.count(w));
 		if (_P.count(w) == 1 && _P.at(w) == v) {
@@ -113,19 +214,101 @@ public:
 		if (_pre.at(v) < _pre.at(w)) {
 			return 2;
 		}
-		if (_post.at(v) < _post.at(w)) {
+		if (_post.at(v) <= _post.at(w)) {
 			return 1;
 		}
 		return 3;
 	}
 
 private:
-	std::unordered_map<Vertex, std::size_t> _pre, _post, _C;
-	std::unordered_map<Vertex, Vertex> _P;
+	// vertex maps and edge digraphs of a run come from one arena, freed
+	// together with it
+	arena_ptr _arena;
+	std::pmr::unordered_map<Vertex, std::size_t> _pre{_arena.get()}, _post{_arena.get()}, _C{_arena.get()};
+	std::pmr::unordered_map<Vertex, Vertex> _P{_arena.get()};
 	std::size_t _time, _ncc;
-	digraph<Vertex> _back, _cross, _forward;
+	digraph<Vertex> _back{_arena.get()}, _cross{_arena.get()}, _forward{_arena.get()};
 	std::list<Vertex> _ts;
 
+	static constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+
+	// explicit stack frame, a vertex and its next unexplored neighbor
+	template <class Set>
+	struct Frame {
+		Vertex v;
+		typename Set::const_iterator next, end;
+	};
+
+	// dense state of a csr search, indexed by id
+	std::vector<std::size_t> _dpre, _dpost, _dC;
+	std::vector<Id> _dP;
+
+	// snapshot stack frame, a vertex id and its next unexplored neighbor
+	template <class It>
+	struct DFrame {
+		Id v;
+		It next, end;
+	};
+
+	// number v and push it on the stack
+	template <class G, class Set>
+	void enter(const G &D, const Vertex &v, std::vector< Frame<Set> > &stack) {
+		_pre[v] = _time++;
+		_C[v] = _ncc;
+		STATS_ADD(dfs_vertices, 1);
+		const Set &adj = D.Adj(v);
+		stack.push_back(Frame<Set>{v, adj.begin(), adj.end()});
+	}
+
+	template <class Snapshot, class It>
+	void enter(const Snapshot &D, Id v, std::vector< DFrame<It> > &stack) {
+		_dpre[v] = _time++;
+		_dC[v] = _ncc;
+		STATS_ADD(dfs_vertices, 1);
+		typename Snapshot::Range adj = D.Adj(v);
+		stack.push_back(DFrame<It>{v, adj.begin(), adj.end()});
+	}
+
+	// copy dense state into the vertex maps, classify edges and release it
+	template <class Snapshot>
+	void translate(const Snapshot &D) {
+		_pre.reserve(D.n());
+		_post.reserve(D.n());
+		_C.reserve(D.n());
+		_P.reserve(D.n());
+		for (Id v = 0; v < D.n(); v++) {
+			_pre[D.vertex(v)] = _dpre[v];
+			_post[D.vertex(v)] = _dpost[v];
+			_C[D.vertex(v)] = _dC[v];
+			if (_dP[v] != csr<Vertex>::none) {
+				_P[D.vertex(v)] = D.vertex(_dP[v]);
+			}
+			_back.addVertex(D.vertex(v));
+			_cross.addVertex(D.vertex(v));
+			_forward.addVertex(D.vertex(v));
+		}
+
+		for (Id v = 0; v < D.n(); v++) {
+			for (Id w : D.Adj(v)) {
+				if (_dP[w] == v) {
+					continue;
+				}
+				if (_dpre[v] < _dpre[w]) {
+					_forward.addEdge(D.vertex(v), D.vertex(w));
+				} else if (_dpost[v] <= _dpost[w]) {
+					_back.addEdge(D.vertex(v), D.vertex(w));
+				} else {
+					_cross.addEdge(D.vertex(v), D.vertex(w));
+				}
+			}
+		}
+
+		std::vector<std::size_t>().swap(_dpre);
+		std::vector<std::size_t>().swap(_dpost);
+		std::vector<std::size_t>().swap(_dC);
+		std::vector<Id>().swap(_dP);
+	}
+
 };
 
 #endif // DFS_H
@@ -2,22 +2,34 @@
 #define DIGRAPH_H
 
 #include <unordered_map>
-#include <unordered_set>
+#include <memory_resource>
 #include <list>
 #include <iostream>
 #include <fstream>
 #include <cassert>
 
+#include "../graph/view.h"
+#include "../graph/adjacency.h"
+#include "../graph/stats.h"
+#include "visit.h"
+
 template <class Vertex> class DFS;
 template <class Vertex> class TSCC;
 
-template <class Vertex>
+// Adjacency picks the neighbor set of each vertex (adjacency.h), with
+// bidirectional<...> the in neighbors are kept in sync with every edge
+template <class Vertex, class Adjacency>
 class digraph {
 public:
-	typedef std::unordered_set<Vertex> VertexSet;
+	typedef typename Adjacency::template set<Vertex> VertexSet;
+	typedef key_view< std::pmr::unordered_map<Vertex, VertexSet> > VertexRange;
 
 	// default constructor
-	digraph() { }
+	digraph() : _m(0) { }
+
+	// adjacency allocated from r (e.g. an arena), which must outlive the
+	// graph; copies allocate from the default resource
+	explicit digraph(std::pmr::memory_resource *r) : _t(r), _r(r), _m(0) { }
 
 	// number of vertices
 	std::size_t n() const {
@@ -26,20 +38,12 @@ public:
 
 	// number of edges
 	std::size_t m() const {
-		std::size_t ans(0);
-		for (auto &p : _t) {
-			ans += p.second.size();
-		}
-		return ans;
+		return _m;
 	}
 
-	// return set of all vertices
-	VertexSet V() const {
-		VertexSet ans;
-		for (auto &p : _t) {
-			ans.insert(p.first);
-		}
-		return ans;
+	// return view of all vertices
+	VertexRange V() const {
+		return VertexRange(_t);
 	}
 
 	// check if vertex is in graph
@@ -52,8 +56,8 @@ public:
 		return isVertex(v) && isVertex(w) && (_t.at(v).count(w) != 0);
 	}
 
-	// return set of adjacent vertices
-	VertexSet Adj(const Vertex &v) const {
+	// return set of adjacent vertices without copying
+	const VertexSet& Adj(const Vertex &v) const {
 		assert(isVertex(v));
 		return _t.at(v);
 	}
@@ -64,9 +68,21 @@ public:
 		return _t.at(v).size();
 	}
 
-	// return in degree / number of adjacent vertices to v
+	// return set of vertices with an edge to v without copying, only if
+	// in edges are kept
+	const VertexSet& InAdj(const Vertex &v) const {
+		static_assert(Adjacency::in_edges, "InAdj needs a bidirectional<...> policy");
+		assert(isVertex(v));
+		return _r.at(v);
+	}
+
+	// return in degree / number of adjacent vertices to v, O(1) if in
+	// edges are kept and a scan of every vertex otherwise
 	std::size_t indeg(const Vertex &v) const {
 		assert(isVertex(v));
+		if constexpr (Adjacency::in_edges) {
+			return _r.at(v).size();
+		}
 
 		std::size_t ans(0);
 		for (auto &p : _t) {
@@ -79,7 +95,10 @@ public:
 	bool addVertex(const Vertex &v) {
 		if (isVertex(v)) { return false; }
 
-		_t[v] = VertexSet();
+		_t.try_emplace(v);
+		if constexpr (Adjacency::in_edges) {
+			_r.try_emplace(v);
+		}
 		return true;
 	}
 
@@ -89,6 +108,10 @@ public:
 		if (isEdge(v, w)) { return false; }
 
 		_t[v].insert(w);
+		if constexpr (Adjacency::in_edges) {
+			_r[w].insert(v);
+		}
+		_m++;
 		return true;
 	}
 
@@ -96,10 +119,29 @@ public:
 	void removeVertex(const Vertex &v) {
 		assert(isVertex(v));
 
+		// only the neighbors of v change, a self loop is both an out and
+		// an in edge
+		if constexpr (Adjacency::in_edges) {
+			VertexSet &out = _t.at(v), &in = _r.at(v);
+			_m -= out.size() + in.size() - out.count(v);
+			for (auto &w : out) {
+				_r.at(w).erase(v);
+			}
+			for (auto &u : in) {
+				if (u != v) {
+					_t.at(u).erase(v);
+				}
+			}
+			_t.erase(v);
+			_r.erase(v);
+			return;
+		}
+
 		for (auto &p : _t) {
-			p.second.erase(v);
+			_m -= p.second.erase(v);
 		}
 
+		_m -= _t[v].size();
 		_t.erase(v);
 	}
 
@@ -107,25 +149,44 @@ public:
 	void removeEdge(const Vertex &v, const Vertex &w) {
 		assert(isVertex(v) && isVertex(w) && isEdge(v, w));
 		_t[v].erase(w);
+		if constexpr (Adjacency::in_edges) {
+			_r[w].erase(v);
+		}
+		_m--;
 	}
 
-	// return true if no cycles
+	// return true if no cycles, stopping at the first back edge
 	bool isDAG() const {
-		DFS<Vertex> d(*this);
-		digraph<Vertex> back = d.back();
-		return (back.m() == 0);
+		cycle_visitor<Vertex> vis;
+		depth_first(*this, vis);
+		return !vis.cyclic;
 	}
 
-	// return topological order of vertices if is DAG
+	// return topological order of vertices if is DAG, in one search
 	std::list<Vertex> ts() const {
-		assert(isDAG());
-		DFS<Vertex> d(*this);
-		return d.ts();
+		topological_visitor<Vertex> vis;
+		depth_first(*this, vis);
+		assert(!vis.cyclic);
+		return std::move(vis.order);
 	}
 
-	// return the reverse digraph
-	digraph<Vertex> reverse() const {
-		digraph<Vertex> rev;
+	// return view of the reverse digraph without copying, only if in edges
+	// are kept
+	transpose_view<Vertex, Adjacency> transpose() const {
+		return transpose_view<Vertex, Adjacency>(*this);
+	}
+
+	// return the reverse digraph, a swap of the in and out sets if in edges
+	// are kept
+	digraph<Vertex, Adjacency> reverse() const {
+		digraph<Vertex, Adjacency> rev;
+		if constexpr (Adjacency::in_edges) {
+			rev._t = _r;
+			rev._r = _t;
+			rev._m = _m;
+			return rev;
+		}
+
 		for (auto &v : V()) {
 			rev.addVertex(v);
 		}
@@ -137,8 +198,15 @@ public:
 		return rev;
 	}
 
-	// return the strongly connected components using Kosaraju's algorithm
+	// return the strongly connected components using Kosaraju's algorithm,
+	// the first pass walks the in edges directly if they are kept
 	std::unordered_map<Vertex, std::size_t> Kscc() const {
+		STATS_PHASE("Kscc");
+		if constexpr (Adjacency::in_edges) {
+			DFS<Vertex> D1(transpose());
+			DFS<Vertex> D2(*this, D1.ts());
+			return D2.components();
+		}
 		DFS<Vertex> D1(reverse());
 		DFS<Vertex> D2(*this, D1.ts());
 		return D2.components();
@@ -146,17 +214,66 @@ public:
 
 private:
 	// adjacency "hashmap" representation
-	std::unordered_map<Vertex, VertexSet> _t;
+	std::pmr::unordered_map<Vertex, VertexSet> _t;
+	std::pmr::unordered_map<Vertex, VertexSet> _r;	// in neighbors, empty unless kept
+	std::size_t _m;							// number of edges
+
+};
+
+// read only transpose of a digraph keeping in edges, Adj is InAdj of the
+// digraph; valid while the digraph is unchanged
+template <class Vertex, class Adjacency>
+class transpose_view {
+public:
+	typedef typename digraph<Vertex, Adjacency>::VertexSet VertexSet;
+	typedef typename digraph<Vertex, Adjacency>::VertexRange VertexRange;
+
+	explicit transpose_view(const digraph<Vertex, Adjacency> &D) : _D(&D) {
+		static_assert(Adjacency::in_edges, "transpose_view needs a bidirectional<...> policy");
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		return _D->n();
+	}
+
+	// number of edges
+	std::size_t m() const {
+		return _D->m();
+	}
+
+	// return view of all vertices
+	VertexRange V() const {
+		return _D->V();
+	}
+
+	// check if vertex is in graph
+	bool isVertex(const Vertex &v) const {
+		return _D->isVertex(v);
+	}
+
+	// return true if edge is in the transpose
+	bool isEdge(const Vertex &v, const Vertex &w) const {
+		return _D->isEdge(w, v);
+	}
+
+	// return set of adjacent vertices in the transpose without copying
+	const VertexSet& Adj(const Vertex &v) const {
+		return _D->InAdj(v);
+	}
+
+private:
+	const digraph<Vertex, Adjacency> *_D;
 
 };
 
 // input digraph
-template <class Vertex>
-std::istream& operator >> (std::istream &is, digraph<Vertex> &D) {
+template <class Vertex, class Adjacency>
+std::istream& operator >> (std::istream &is, digraph<Vertex, Adjacency> &D) {
 	std::size_t n, m;
 	Vertex v, w;
 
-	D = digraph<Vertex>();
+	D = digraph<Vertex, Adjacency>();
 
 	is >> n >> m;
 	for (std::size_t i = 0; i < n; i++) {
@@ -174,8 +291,8 @@ std::istream& operator >> (std::istream &is, digraph<Vertex> &D) {
 
 
 // output digraph
-template <class Vertex>
-std::ostream& operator << (std::ostream &os, digraph<Vertex> &D) {
+template <class Vertex, class Adjacency>
+std::ostream& operator << (std::ostream &os, digraph<Vertex, Adjacency> &D) {
 	os << "\nDigraph:" << std::endl;
 	os << "# Vertices: " << D.n() << "\n# Edges: " << D.m() << std::endl << std::endl;
 
@@ -199,9 +316,9 @@ std::ostream& operator << (std::ostream &os, digraph<Vertex> &D) {
 	std::unordered_map<Vertex, std::size_t> _pre = d.pre();
 	std::unordered_map<Vertex, std::size_t> _post = d.post();
 	std::unordered_map<Vertex, Vertex> _P = d.dfTree();
-	std::size_t nback = d.back().m();
-	std::size_t nforward = d.forward().m();
-	std::size_t ncross = d.cross().m();
+	digraph<Vertex> back = d.back();
+	digraph<Vertex> forward = d.forward();
+	digraph<Vertex> cross = d.cross();
 
 	os << "Pre:" << std::endl;
 	for (auto &p : _pre) {
@@ -221,25 +338,25 @@ std::ostream& operator << (std::ostream &os, digraph<Vertex> &D) {
 	}
 	os << std::endl;
 
-	os << "Back Edges: " << nback << std::endl;
-	for (auto &v : d.back().V()) {
-		for (auto &w : d.back().Adj(v)) {
+	os << "Back Edges: " << back.m() << std::endl;
+	for (auto &v : back.V()) {
+		for (auto &w : back.Adj(v)) {
 			os << v << " " << w << std::endl;
 		}
 	}
 	os << std::endl;
 
-	os << "Forward Edges: " << nforward << std::endl;
-	for (auto &v : d.forward().V()) {
-		for (auto &w : d.forward().Adj(v)) {
+	os << "Forward Edges: " << forward.m() << std::endl;
+	for (auto &v : forward.V()) {
+		for (auto &w : forward.Adj(v)) {
 			os << v << " " << w << std::endl;
 		}
 	}
 	os << std::endl;
 
-	os << "Cross Edges: " << ncross << std::endl;
-	for (auto &v : d.cross().V()) {
-		for (auto &w : d.cross().Adj(v)) {
+	os << "Cross Edges: " << cross.m() << std::endl;
+	for (auto &v : cross.V()) {
+		for (auto &w : cross.Adj(v)) {
 			os << v << " " << w << std::endl;
 		}
 	}
@@ -0,0 +1,363 @@
+#ifndef ISCC_H
+#define ISCC_H
+
+#include <unordered_map>
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cassert>
+
+#include "digraph.h"
+#include "tscc.h"
+#include "../graph/stats.h"
+
+// strongly connected components kept under edge insertions: the
+// components are held in a topological order of the condensation, and an
+// edge v -> w against that order searches (Pearce and Kelly) only the
+// components reachable from w's and ordered before v's, and those reaching
+// v's and ordered after w's; components found by both searches lie on the
+// new cycle and are merged, the rest are reordered around them
+//
+// each component keeps the edges leaving and entering it, pruned as they
+// are searched and merged smaller into larger, so a search costs the
+// degrees of the condensation rather than of the vertices
+//
+//   ISCC<int> S(D);
+//   S.addEdge(3, 1);        // merges if 1 reaches 3
+//   S.components();         // ids in reverse topological order like TSCC
+template <class Vertex>
+class ISCC {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	// no vertices
+	ISCC() : _ncc(0), _mark(0), _holes(0), _pass(0) { }
+
+	// components of D, found once by Tarjan's algorithm
+	template <class Adjacency>
+	explicit ISCC(const digraph<Vertex, Adjacency> &D) : _ncc(0), _mark(0), _holes(0), _pass(0) {
+		for (auto &v : D.V()) {
+			addVertex(v);
+		}
+
+		// Tarjan numbers components in reverse topological order
+		TSCC<Vertex> T(D);
+		std::size_t k = T.ncc();
+		std::vector<Id> rep(k, none);
+		for (auto &p : T.components()) {
+			Id v = _id.at(p.first), c = rep[p.second];
+			if (c == none) {
+				rep[p.second] = v;
+			} else {
+				merge(c, v);
+			}
+		}
+		_at.assign(k, none);
+		for (std::size_t c = 0; c < k; c++) {
+			_ord[rep[c]] = k - 1 - c;
+			_at[k - 1 - c] = rep[c];
+		}
+		_ncc = k;
+
+		for (auto &v : D.V()) {
+			for (auto &w : D.Adj(v)) {
+				link(_id.at(v), _id.at(w));
+			}
+		}
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		return _G.n();
+	}
+
+	// number of edges
+	std::size_t m() const {
+		return _G.m();
+	}
+
+	// check if vertex is in graph
+	bool isVertex(const Vertex &v) const {
+		return _id.count(v) != 0;
+	}
+
+	// return true if edge is in graph
+	bool isEdge(const Vertex &v, const Vertex &w) const {
+		return isVertex(v) && isVertex(w) && _G.isEdge(_id.at(v), _id.at(w));
+	}
+
+	// return true and add vertex, a component of its own last in the order,
+	// if not already in graph
+	bool addVertex(const Vertex &v) {
+		if (isVertex(v)) { return false; }
+
+		Id u = Id(_label.size());
+		_id.emplace(v, u);
+		_label.push_back(v);
+		_G.addVertex(u);
+		_comp.push_back(u);
+		_members.emplace_back(1, u);
+		_out.emplace_back();
+		_in.emplace_back();
+		_listed.push_back(0);
+		_ord.push_back(_at.size());
+		_fmark.push_back(0);
+		_bmark.push_back(0);
+		_at.push_back(u);
+		_ncc++;
+		return true;
+	}
+
+	// return true and add edge if not already in graph, merging the
+	// components it closes a cycle through
+	bool addEdge(const Vertex &v, const Vertex &w) {
+		if (!isVertex(v) || !isVertex(w)) { return false; }
+		Id x = _id.at(v), y = _id.at(w);
+		if (!link(x, y)) { return false; }
+
+		Id cv = _comp[x], cw = _comp[y];
+		if (cv != cw && _ord[cw] < _ord[cv]) {
+			_mark++;
+			bool cycle = forward(cw, cv);
+			backward(cv, cw);
+			reorder(cv, cycle);
+		}
+		return true;
+	}
+
+	// return true if v and w are in the same component
+	bool sameComponent(const Vertex &v, const Vertex &w) const {
+		assert(isVertex(v) && isVertex(w));
+		return _comp[_id.at(v)] == _comp[_id.at(w)];
+	}
+
+	// component ids for each vertex, in reverse topological order like TSCC
+	std::unordered_map<Vertex, std::size_t> components() const {
+		std::vector<std::size_t> number(_label.size());
+		std::size_t k(0);
+		for (auto it = _at.rbegin(); it != _at.rend(); it++) {
+			if (*it != none) {
+				number[*it] = k++;
+			}
+		}
+
+		std::unordered_map<Vertex, std::size_t> ans;
+		ans.reserve(_label.size());
+		for (Id u = 0; u < _label.size(); u++) {
+			ans[_label[u]] = number[_comp[u]];
+		}
+		return ans;
+	}
+
+	// number of strongly connected components
+	std::size_t ncc() const {
+		return _ncc;
+	}
+
+private:
+	static constexpr Id none = std::numeric_limits<Id>::max();
+
+	digraph<Id> _G;								// the graph over dense ids
+	std::unordered_map<Vertex, Id> _id;			// vertex -> id
+	std::vector<Vertex> _label;					// id -> vertex
+	std::vector<Id> _comp;						// id -> component, one of its ids
+	std::vector< std::vector<Id> > _members;	// ids of each component, empty if merged
+	std::vector< std::vector<Id> > _out, _in;	// far ends of edges leaving, entering each
+	std::vector<std::size_t> _ord;				// position of each component
+	std::vector<Id> _at;						// position -> component, none if empty
+	std::vector<std::size_t> _fmark, _bmark;	// last insertion searching each component
+	std::vector<std::size_t> _listed;			// last list pass keeping each component
+	std::size_t _ncc, _mark, _holes, _pass;
+
+	// scratch of one insertion, the positions and components found forward
+	// and backward
+	typedef std::pair<std::size_t, Id> Found;
+	std::vector<Found> _F, _B;
+	std::vector<Id> _stack, _cycle, _adj;
+	std::vector<std::size_t> _pos;
+
+	// search from cw the components ordered before cv, true if one of them
+	// has an edge into cv (a new cycle)
+	bool forward(Id cw, Id cv) {
+		std::size_t ub = _ord[cv];
+		bool cycle = false;
+		_F.clear();
+		_stack.assign(1, cw);
+		_fmark[cw] = _mark;
+		while (!_stack.empty()) {
+			Id c = _stack.back();
+			_stack.pop_back();
+			_F.emplace_back(_ord[c], c);
+			STATS_ADD(dfs_vertices, 1);
+			for (Id cx : neighbors(c, _out[c])) {
+				if (cx == cv) {
+					cycle = true;
+				} else if (_fmark[cx] != _mark && _ord[cx] < ub) {
+					_fmark[cx] = _mark;
+					_stack.push_back(cx);
+				}
+			}
+		}
+		return cycle;
+	}
+
+	// search back from cv the components ordered after cw, and cw itself
+	// exactly if the edge closed a cycle
+	void backward(Id cv, Id cw) {
+		std::size_t lb = _ord[cw];
+		_B.clear();
+		_stack.assign(1, cv);
+		_bmark[cv] = _mark;
+		while (!_stack.empty()) {
+			Id c = _stack.back();
+			_stack.pop_back();
+			_B.emplace_back(_ord[c], c);
+			STATS_ADD(dfs_vertices, 1);
+			for (Id cx : neighbors(c, _in[c])) {
+				if (_bmark[cx] != _mark && _ord[cx] >= lb) {
+					_bmark[cx] = _mark;
+					_stack.push_back(cx);
+				}
+			}
+		}
+	}
+
+	// share the positions of both searches: backward only components first,
+	// then the merged cycle, then forward only ones, each group keeping its
+	// order; the cycle's other positions are left empty
+	void reorder(Id cv, bool cycle) {
+		std::sort(_F.begin(), _F.end());
+		std::sort(_B.begin(), _B.end());
+
+		// a component found both ways reaches v's and is reached from w's,
+		// and so does v's own (never entered forward)
+		_pos.clear();
+		_cycle.clear();
+		std::size_t f(0), b(0);
+		for (auto &p : _F) {
+			_pos.push_back(p.first);
+			if (_bmark[p.second] == _mark) {
+				_cycle.push_back(p.second);
+			} else {
+				_F[f++] = p;
+			}
+		}
+		for (auto &p : _B) {
+			if (_fmark[p.second] == _mark) {
+				continue;
+			}
+			_pos.push_back(p.first);
+			if (cycle && p.second == cv) {
+				_cycle.push_back(p.second);
+			} else {
+				_B[b++] = p;
+			}
+		}
+		_F.resize(f);
+		_B.resize(b);
+		assert(cycle == !_cycle.empty());
+		std::sort(_pos.begin(), _pos.end());
+
+		std::size_t i(0);
+		for (auto &p : _B) {
+			place(p.second, _pos[i++]);
+		}
+		if (cycle) {
+			Id c = _cycle.front();
+			for (Id d : _cycle) {
+				if (_members[d].size() > _members[c].size()) {
+					c = d;
+				}
+			}
+			for (Id d : _cycle) {
+				if (d != c) {
+					merge(c, d);
+				}
+			}
+			place(c, _pos[i++]);
+			for (; i < _pos.size() - _F.size(); i++) {
+				_at[_pos[i]] = none;
+			}
+			_ncc -= _cycle.size() - 1;
+			_holes += _cycle.size() - 1;
+		}
+		for (auto &p : _F) {
+			place(p.second, _pos[i++]);
+		}
+
+		if (_holes > _at.size()/2) {
+			compact();
+		}
+	}
+
+	void place(Id c, std::size_t pos) {
+		_ord[c] = pos;
+		_at[pos] = c;
+	}
+
+	// move the members and edge lists of component d into component c,
+	// the shorter list appended to the longer
+	void merge(Id c, Id d) {
+		for (Id u : _members[d]) {
+			_comp[u] = c;
+			_members[c].push_back(u);
+		}
+		std::vector<Id>().swap(_members[d]);
+		for (auto *l : {&_out, &_in}) {
+			std::vector<Id> &a = (*l)[c], &b = (*l)[d];
+			if (a.size() < b.size()) {
+				a.swap(b);
+			}
+			a.insert(a.end(), b.begin(), b.end());
+			std::vector<Id>().swap(b);
+		}
+	}
+
+	// add edge x -> y to the graph and, between components, to their lists
+	bool link(Id x, Id y) {
+		if (!_G.addEdge(x, y)) {
+			return false;
+		}
+		if (_comp[x] != _comp[y]) {
+			_out[_comp[x]].push_back(y);
+			_in[_comp[y]].push_back(x);
+		}
+		return true;
+	}
+
+	// the components at the other end of the edge list l of component c,
+	// each once; l keeps one id per such component, dropping the ids merged
+	// into c or into a component already listed
+	const std::vector<Id>& neighbors(Id c, std::vector<Id> &l) {
+		_pass++;
+		_adj.clear();
+		std::size_t k(0);
+		for (Id x : l) {
+			STATS_ADD(dfs_edges, 1);
+			Id cx = _comp[x];
+			if (cx != c && _listed[cx] != _pass) {
+				_listed[cx] = _pass;
+				l[k++] = x;
+				_adj.push_back(cx);
+			}
+		}
+		l.resize(k);
+		return _adj;
+	}
+
+	// close the empty positions, keeping the order
+	void compact() {
+		std::size_t k(0);
+		for (Id c : _at) {
+			if (c != none) {
+				place(c, k++);
+			}
+		}
+		_at.resize(k);
+		_holes = 0;
+	}
+
+};
+
+#endif // ISCC_H
@@ -2,6 +2,7 @@
 #include <fstream>
 #include <cassert>
 
+#include "../graph/symbol.h"
 #include "digraph.h"
 #include "dfs.h"
 #include "tscc.h"
@@ -9,7 +10,7 @@
 using namespace std;
 
 int main() {
-	digraph<string> D;
+	digraph<symbol> D;
 	cin >> D;
 	cout << D;
 }
@@ -0,0 +1,437 @@
+#ifndef PSCC_H
+#define PSCC_H
+
+#include <unordered_map>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#include "../graph/csr.h"
+#include "../graph/thread_pool.h"
+#include "../graph/reorder.h"
+#include "../graph/stats.h"
+
+// parallel strongly connected components on a csr snapshot of a digraph
+// (Multistep, Slota et al.): trim vertices without live in or out
+// neighbors, each a component of its own, take the component of a high
+// degree pivot with a forward and a backward search, trim again, then
+// until no vertex is left propagate the largest id forward as a color and
+// search back from every vertex that kept its own color through vertices
+// of that color. searches are level synchronous over the thread pool and
+// vertices are claimed with compare-and-swap
+//
+// components get the same partition as TSCC, numbered in a reverse
+// topological order of the condensation as TSCC numbers them (the ids of
+// unrelated components may differ)
+template <class Vertex>
+class PSCC {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	PSCC(const csr<Vertex> &D, thread_pool &pool = thread_pool::shared())
+		: _pool(pool), _comp(D.n()), _color(D.n()), _seen(D.n()), _local(pool.size()) {
+		STATS_PHASE("PSCC");
+		assert(D.directed());
+		_label.store(0, std::memory_order_relaxed);
+		_round = 0;
+
+		_active.resize(D.n());
+		_pool.parallel_for(D.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				_comp[v].store(none, std::memory_order_relaxed);
+				_seen[v].store(0, std::memory_order_relaxed);
+				_active[v] = v;
+			}
+		});
+		transpose(D);
+
+		trim(D);
+		pivot(D);
+		trim(D);
+		while (!_active.empty()) {
+			color(D);
+		}
+		number(D);
+
+		_C.reserve(D.n());
+		for (Id v = 0; v < D.n(); v++) {
+			_C[D.vertex(v)] = _comp[v].load(std::memory_order_relaxed);
+		}
+	}
+
+	// component ids for each vertex
+	std::unordered_map<Vertex, std::size_t> components() const {
+		return _C;
+	}
+
+	// number of strongly connected components
+	std::size_t ncc() const {
+		return _ncc;
+	}
+
+private:
+	static constexpr Id none = csr<Vertex>::none;
+	static constexpr std::size_t grain = 1024;		// vertices per task
+
+	thread_pool &_pool;
+	std::vector< std::atomic<Id> > _comp;		// raw component label, none while live
+	std::vector< std::atomic<Id> > _color;		// pivot or propagated color
+	std::vector< std::atomic<std::uint32_t> > _seen;	// round a vertex was last queued in
+	std::vector< std::vector<Id> > _local;		// per worker output buffers
+	std::vector<Id> _active;					// live vertices
+	std::vector<std::size_t> _roff;				// in neighbors, as a csr
+	std::vector<Id> _radj;
+	std::atomic<Id> _label;						// next raw component label
+	std::uint32_t _round;
+	std::size_t _ncc;
+	std::unordered_map<Vertex, std::size_t> _C;
+
+	bool live(Id v) const {
+		return _comp[v].load(std::memory_order_relaxed) == none;
+	}
+
+	// in neighbors of every vertex, sources land in any order; one worker
+	// counts without atomics
+	void transpose(const csr<Vertex> &D) {
+		if (_pool.size() == 1) {
+			::transpose(D, _roff, _radj);
+			return;
+		}
+
+		array_view<std::size_t> off = D.offsets();
+		array_view<Id> adj = D.targets();
+		std::vector< std::atomic<std::size_t> > at(D.n());
+		_pool.parallel_for(D.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				at[v].store(0, std::memory_order_relaxed);
+			}
+		});
+		_pool.parallel_for(D.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t a = off[lo]; a < off[hi]; a++) {
+				at[adj[a]].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		_roff.assign(D.n() + 1, 0);
+		for (Id v = 0; v < D.n(); v++) {
+			_roff[v+1] = _roff[v] + at[v].load(std::memory_order_relaxed);
+			at[v].store(_roff[v], std::memory_order_relaxed);
+		}
+
+		_radj.resize(D.arcs());
+		_pool.parallel_for(D.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				for (std::size_t a = off[v]; a < off[v+1]; a++) {
+					_radj[at[adj[a]].fetch_add(1, std::memory_order_relaxed)] = v;
+				}
+			}
+		});
+	}
+
+	// replace out with the concatenated per worker buffers
+	void gather(std::vector<Id> &out) {
+		std::size_t total(0);
+		std::vector<std::size_t> at(_local.size());
+		for (std::size_t i = 0; i < _local.size(); i++) {
+			at[i] = total;
+			total += _local[i].size();
+		}
+		out.resize(total);
+		_pool.run([&](std::size_t i) {
+			std::copy(_local[i].begin(), _local[i].end(), out.begin() + at[i]);
+			_local[i].clear();
+		});
+	}
+
+	// drop vertices that got a component from the live list
+	void compact() {
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+			for (std::size_t k = lo; k < hi; k++) {
+				if (live(_active[k])) {
+					_local[i].push_back(_active[k]);
+				}
+			}
+		});
+		gather(_active);
+	}
+
+	// level synchronous search from front along off/adj, claim(v, w) is
+	// true once for every w the search moves on to
+	template <class Claim>
+	void reach(std::vector<Id> &front, const std::size_t *off, const Id *adj, const Claim &claim) {
+		while (!front.empty()) {
+			_pool.parallel_for(front.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+				for (std::size_t k = lo; k < hi; k++) {
+					Id v = front[k];
+					for (std::size_t a = off[v]; a < off[v+1]; a++) {
+						STATS_ADD(bfs_edges, 1);
+						if (claim(v, adj[a])) {
+							_local[i].push_back(adj[a]);
+						}
+					}
+				}
+			});
+			gather(front);
+		}
+	}
+
+	// live neighbors of every live vertex in off/adj, self loops left out
+	void count(std::vector< std::atomic<Id> > &k, const std::size_t *off, const Id *adj) {
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t j = lo; j < hi; j++) {
+				Id v = _active[j], c(0);
+				for (std::size_t a = off[v]; a < off[v+1]; a++) {
+					c += (adj[a] != v && live(adj[a]));
+				}
+				k[v].store(c, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	// a vertex without live in or out neighbors is on no cycle of live
+	// vertices and a component of its own; removing it may leave its
+	// neighbors without any, so trimming continues from the removed
+	// vertices until none is left to remove
+	void trim(const csr<Vertex> &D) {
+		const std::size_t *off = D.offsets().data();
+		const Id *adj = D.targets().data();
+		std::vector< std::atomic<Id> > in(D.n()), out(D.n());
+		count(in, _roff.data(), _radj.data());
+		count(out, off, adj);
+
+		auto take = [&](Id v) {
+			Id x = none;
+			return _comp[v].compare_exchange_strong(x, _label.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+		};
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+			for (std::size_t k = lo; k < hi; k++) {
+				Id v = _active[k];
+				if (in[v].load(std::memory_order_relaxed) == 0 || out[v].load(std::memory_order_relaxed) == 0) {
+					_comp[v].store(_label.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+					_local[i].push_back(v);
+				}
+			}
+		});
+
+		// every edge of a removed vertex to a live one is counted off once
+		std::vector<Id> front;
+		gather(front);
+		while (!front.empty()) {
+			_pool.parallel_for(front.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+				for (std::size_t k = lo; k < hi; k++) {
+					Id v = front[k];
+					for (std::size_t a = off[v]; a < off[v+1]; a++) {
+						Id w = adj[a];
+						if (w != v && live(w) && in[w].fetch_sub(1, std::memory_order_relaxed) == 1 && take(w)) {
+							_local[i].push_back(w);
+						}
+					}
+					for (std::size_t a = _roff[v]; a < _roff[v+1]; a++) {
+						Id u = _radj[a];
+						if (u != v && live(u) && out[u].fetch_sub(1, std::memory_order_relaxed) == 1 && take(u)) {
+							_local[i].push_back(u);
+						}
+					}
+				}
+			});
+			gather(front);
+		}
+		compact();
+	}
+
+	// component of the live vertex with the most in and out edges, the
+	// giant component of most large graphs
+	void pivot(const csr<Vertex> &D) {
+		if (_active.empty()) {
+			return;
+		}
+
+		std::vector<std::uint64_t> score(_local.size(), 0);
+		std::vector<Id> best(_local.size(), none);
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+			for (std::size_t k = lo; k < hi; k++) {
+				Id v = _active[k];
+				std::uint64_t s = std::uint64_t(D.deg(v) + 1)*(_roff[v+1] - _roff[v] + 1);
+				if (s > score[i] || (s == score[i] && v < best[i])) {
+					score[i] = s;
+					best[i] = v;
+				}
+			}
+		});
+		Id p = none;
+		std::uint64_t top(0);
+		for (std::size_t i = 0; i < best.size(); i++) {
+			if (best[i] != none && (score[i] > top || (score[i] == top && best[i] < p))) {
+				top = score[i];
+				p = best[i];
+			}
+		}
+
+		// forward from p marks its color, backward through that color
+		// finds the component
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t k = lo; k < hi; k++) {
+				_color[_active[k]].store(none, std::memory_order_relaxed);
+			}
+		});
+		_color[p].store(p, std::memory_order_relaxed);
+		std::vector<Id> front(1, p);
+		reach(front, D.offsets().data(), D.targets().data(), [&](Id, Id w) {
+			Id x = none;
+			return live(w) && _color[w].load(std::memory_order_relaxed) == none
+				&& _color[w].compare_exchange_strong(x, p, std::memory_order_relaxed);
+		});
+
+		Id c = _label.fetch_add(1, std::memory_order_relaxed);
+		_comp[p].store(c, std::memory_order_relaxed);
+		front.assign(1, p);
+		reach(front, _roff.data(), _radj.data(), [&](Id, Id w) {
+			Id x = none;
+			return _color[w].load(std::memory_order_relaxed) == p
+				&& _comp[w].compare_exchange_strong(x, c, std::memory_order_relaxed);
+		});
+		compact();
+	}
+
+	// every live vertex takes the largest id that reaches it, a vertex
+	// keeping its own id roots the component of the vertices of its color
+	// it reaches backward
+	void color(const csr<Vertex> &D) {
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t k = lo; k < hi; k++) {
+				_color[_active[k]].store(_active[k], std::memory_order_relaxed);
+			}
+		});
+
+		std::vector<Id> front(_active);
+		const std::size_t *off = D.offsets().data();
+		const Id *adj = D.targets().data();
+		while (!front.empty()) {
+			std::uint32_t round = ++_round;
+			_pool.parallel_for(front.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+				for (std::size_t k = lo; k < hi; k++) {
+					Id v = front[k];
+					Id c = _color[v].load(std::memory_order_relaxed);
+					for (std::size_t a = off[v]; a < off[v+1]; a++) {
+						Id w = adj[a];
+						if (!live(w)) {
+							continue;
+						}
+						Id x = _color[w].load(std::memory_order_relaxed);
+						while (x < c && !_color[w].compare_exchange_weak(x, c, std::memory_order_relaxed)) { }
+						if (x < c && _seen[w].exchange(round, std::memory_order_relaxed) != round) {
+							_local[i].push_back(w);
+						}
+					}
+				}
+			});
+			gather(front);
+		}
+
+		_pool.parallel_for(_active.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+			for (std::size_t k = lo; k < hi; k++) {
+				Id v = _active[k];
+				if (_color[v].load(std::memory_order_relaxed) == v) {
+					_comp[v].store(_label.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+					_local[i].push_back(v);
+				}
+			}
+		});
+		gather(front);
+		reach(front, _roff.data(), _radj.data(), [&](Id v, Id w) {
+			Id x = none;
+			return live(w) && _color[w].load(std::memory_order_relaxed) == _color[v].load(std::memory_order_relaxed)
+				&& _comp[w].compare_exchange_strong(x, _comp[v].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		});
+		compact();
+	}
+
+	// renumber components by smallest vertex, then give the final ids
+	// level by level from the sinks of the condensation, so every edge
+	// between components goes from a larger id to a smaller one
+	void number(const csr<Vertex> &D) {
+		std::vector<Id> dense(_label.load(std::memory_order_relaxed), none);
+		std::vector<Id> comp(D.n());
+		_ncc = 0;
+		for (Id v = 0; v < D.n(); v++) {
+			Id &c = dense[_comp[v].load(std::memory_order_relaxed)];
+			if (c == none) {
+				c = _ncc++;
+			}
+			comp[v] = c;
+		}
+
+		// members of each component, and its edges to other components
+		std::vector<std::size_t> first(_ncc + 1, 0);
+		for (Id v = 0; v < D.n(); v++) {
+			first[comp[v] + 1]++;
+		}
+		for (std::size_t c = 0; c < _ncc; c++) {
+			first[c+1] += first[c];
+		}
+		std::vector<Id> member(D.n());
+		std::vector<std::size_t> next(first.begin(), first.end() - 1);
+		for (Id v = 0; v < D.n(); v++) {
+			member[next[comp[v]]++] = v;
+		}
+
+		std::vector< std::atomic<std::size_t> > out(_ncc);
+		_pool.parallel_for(_ncc, grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t c = lo; c < hi; c++) {
+				out[c].store(0, std::memory_order_relaxed);
+			}
+		});
+		_pool.parallel_for(D.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				std::size_t k(0);
+				for (Id w : D.Adj(v)) {
+					k += (comp[w] != comp[v]);
+				}
+				if (k != 0) {
+					out[comp[v]].fetch_add(k, std::memory_order_relaxed);
+				}
+			}
+		});
+
+		std::vector<Id> front, rank(_ncc);
+		for (Id c = 0; c < _ncc; c++) {
+			if (out[c].load(std::memory_order_relaxed) == 0) {
+				front.push_back(c);
+			}
+		}
+		Id id(0);
+		while (!front.empty()) {
+			std::sort(front.begin(), front.end());
+			for (Id c : front) {
+				rank[c] = id++;
+			}
+			_pool.parallel_for(front.size(), 64, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+				for (std::size_t k = lo; k < hi; k++) {
+					Id c = front[k];
+					for (std::size_t j = first[c]; j < first[c+1]; j++) {
+						Id v = member[j];
+						for (std::size_t a = _roff[v]; a < _roff[v+1]; a++) {
+							Id u = comp[_radj[a]];
+							if (u != c && out[u].fetch_sub(1, std::memory_order_relaxed) == 1) {
+								_local[i].push_back(u);
+							}
+						}
+					}
+				}
+			});
+			gather(front);
+		}
+		assert(id == _ncc);
+
+		_pool.parallel_for(D.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				_comp[v].store(rank[comp[v]], std::memory_order_relaxed);
+			}
+		});
+	}
+
+};
+
+#endif // PSCC_H
@@ -0,0 +1,203 @@
+#ifndef REACH_H
+#define REACH_H
+
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+#include "../graph/csr.h"
+#include "../graph/stats.h"
+#include "condense.h"
+
+// reachability index of a fixed digraph (GRAIL): the strongly connected
+// components are contracted to a DAG and every component gets, for each
+// of a few randomized post order traversals, the interval [lo, post] of
+// post numbers below it, so a reaches b only if b's intervals all nest in
+// a's; Tarjan numbers components in reverse topological order, so also
+// only if a's component id is not smaller than b's
+//
+//   reachability<int> R(D);
+//   R.reaches(u, v);        // O(1) if the labels decide, else a pruned search
+//
+// queries share scratch space and must not run concurrently
+template <class Vertex>
+class reachability {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	// index of D with the given number of interval labels per component
+	template <class Adjacency>
+	explicit reachability(const digraph<Vertex, Adjacency> &D, std::size_t traversals = 2) : _G(D) {
+		label(traversals);
+	}
+
+	explicit reachability(const csr<Vertex> &S, std::size_t traversals = 2) : _G(S) {
+		label(traversals);
+	}
+
+	// number of strongly connected components
+	std::size_t ncc() const {
+		return _G.ncc();
+	}
+
+	// number of edges of the condensation
+	std::size_t dag_edges() const {
+		return _G.m();
+	}
+
+	// component id of v, in reverse topological order like TSCC
+	std::size_t component(const Vertex &v) const {
+		return _G.component(v);
+	}
+
+	// return true if there is a path from u to v
+	bool reaches(const Vertex &u, const Vertex &v) const {
+		return reaches_component(component(u), component(v));
+	}
+
+	// return true if there is a path from component a to component b
+	bool reaches_component(Id a, Id b) const {
+		assert(a < ncc() && b < ncc());
+		if (a == b) {
+			return true;
+		}
+		if (!maybe(a, b)) {
+			return false;
+		}
+
+		// search the components whose labels do not rule b out
+		_mark++;
+		_stack.assign(1, a);
+		_seen[a] = _mark;
+		while (!_stack.empty()) {
+			Id c = _stack.back();
+			_stack.pop_back();
+			STATS_ADD(dfs_vertices, 1);
+			for (Id x : _G.Adj(c)) {
+				STATS_ADD(dfs_edges, 1);
+				if (x == b) {
+					return true;
+				}
+				if (_seen[x] != _mark && maybe(x, b)) {
+					_seen[x] = _mark;
+					_stack.push_back(x);
+				}
+			}
+		}
+		return false;
+	}
+
+private:
+	condensation<Vertex> _G;
+	std::size_t _k;							// labels per component
+	std::vector<Id> _lo, _post;				// labels of component c at [c*_k, c*_k + _k)
+
+	// scratch of the fallback search, a component is seen if marked with
+	// the current query
+	mutable std::vector<std::size_t> _seen;
+	mutable std::vector<Id> _stack;
+	mutable std::size_t _mark;
+
+	// false if no path from a to b can exist: b is ordered after a or an
+	// interval of b is outside a's
+	bool maybe(Id a, Id b) const {
+		if (a < b) {
+			return false;
+		}
+		for (std::size_t i = 0; i < _k; i++) {
+			if (_lo[b*_k + i] < _lo[a*_k + i] || _post[b*_k + i] > _post[a*_k + i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// one post order traversal per label from the sources of the DAG, each
+	// starting the sources and neighbor lists at a different rotation so
+	// the intervals differ; lo is the smallest post number below c
+	void label(std::size_t traversals) {
+		STATS_PHASE("reachability");
+		assert(traversals > 0);
+		std::size_t k = ncc();
+		_k = traversals;
+		_seen.assign(k, 0);
+		_mark = 0;
+		_lo.assign(k*_k, 0);
+		_post.assign(k*_k, 0);
+
+		std::vector<bool> source(k, true);
+		for (Id c = 0; c < k; c++) {
+			for (Id x : _G.Adj(c)) {
+				source[x] = false;
+			}
+		}
+		std::vector<Id> roots;
+		for (Id c = 0; c < k; c++) {
+			if (source[c]) {
+				roots.push_back(c);
+			}
+		}
+
+		// stack frame, a component and the neighbors left in its rotation
+		struct Frame {
+			Id c;
+			std::size_t next, left;
+		};
+		std::vector<Frame> stack;
+		std::vector<std::size_t> seen(k, 0);
+		std::uint64_t r = 0x9e3779b97f4a7c15ull;
+
+		for (std::size_t i = 0; i < _k; i++) {
+			auto rotation = [&](std::size_t deg) -> std::size_t {
+				if (i == 0 || deg == 0) {
+					return 0;
+				}
+				r ^= r << 13;
+				r ^= r >> 7;
+				r ^= r << 17;
+				return r % deg;
+			};
+			auto enter = [&](Id c) {
+				seen[c] = i + 1;
+				std::size_t deg = _G.Adj(c).size();
+				stack.push_back(Frame{c, rotation(deg), deg});
+				_lo[c*_k + i] = Id(-1);
+			};
+
+			Id post(0);
+			std::size_t start = rotation(roots.size());
+			for (std::size_t j = 0; j < roots.size(); j++) {
+				enter(roots[(start + j) % roots.size()]);
+				while (!stack.empty()) {
+					Frame &f = stack.back();
+					Id c = f.c;
+					if (f.left == 0) {
+						_post[c*_k + i] = post;
+						_lo[c*_k + i] = std::min(_lo[c*_k + i], post);
+						post++;
+						stack.pop_back();
+						if (!stack.empty()) {
+							Id p = stack.back().c;
+							_lo[p*_k + i] = std::min(_lo[p*_k + i], _lo[c*_k + i]);
+						}
+						continue;
+					}
+
+					std::size_t deg = _G.Adj(c).size();
+					Id x = _G.Adj(c).begin()[f.next];
+					f.next = (f.next + 1 == deg) ? 0 : f.next + 1;
+					f.left--;
+					if (seen[x] != i + 1) {
+						enter(x);
+					} else {
+						_lo[c*_k + i] = std::min(_lo[c*_k + i], _lo[x*_k + i]);
+					}
+				}
+			}
+		}
+	}
+
+};
+
+#endif // REACH_H
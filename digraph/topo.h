@@ -0,0 +1,255 @@
+#ifndef TOPO_H
+#define TOPO_H
+
+#include <unordered_map>
+#include <algorithm>
+#include <list>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+#include "digraph.h"
+#include "visit.h"
+#include "../graph/stats.h"
+
+// directed acyclic graph keeping a topological order under edge insertions
+// (Pearce and Kelly): an edge v -> w that already agrees with the order
+// costs O(1), otherwise only the vertices reachable from w and ordered
+// before v, and those reaching v and ordered after w, are searched and
+// shuffled among their own positions; an edge closing a cycle is refused
+//
+//   topological_order<int> T;
+//   T.addVertex(1); T.addVertex(2);
+//   T.addEdge(2, 1);        // true, 2 now before 1
+//   T.addEdge(1, 2);        // false, would be a cycle
+//
+// Adjacency must keep in edges for the backward search
+template <class Vertex, class Adjacency = bidirectional<>>
+class topological_order {
+	static_assert(Adjacency::in_edges, "topological_order needs a bidirectional<...> policy");
+
+public:
+	// empty order
+	topological_order() : _mark(0), _holes(0) { }
+
+	// order of G, starting from its depth first topological sort; if G has
+	// a cycle the order is left empty, check n() against G.n()
+	template <class A>
+	explicit topological_order(const digraph<Vertex, A> &G) : _mark(0), _holes(0) {
+		topological_visitor<Vertex> vis;
+		if (!depth_first(G, vis)) {
+			return;
+		}
+		for (auto &v : vis.order) {
+			addVertex(v);
+		}
+		for (auto &v : G.V()) {
+			for (auto &w : G.Adj(v)) {
+				_D.addEdge(v, w);
+			}
+		}
+	}
+
+	// copies would point into each other's maps
+	topological_order(const topological_order&) = delete;
+	topological_order& operator = (const topological_order&) = delete;
+
+	// number of vertices
+	std::size_t n() const {
+		return _D.n();
+	}
+
+	// number of edges
+	std::size_t m() const {
+		return _D.m();
+	}
+
+	// the acyclic digraph itself
+	const digraph<Vertex, Adjacency>& D() const {
+		return _D;
+	}
+
+	// check if vertex is in graph
+	bool isVertex(const Vertex &v) const {
+		return _D.isVertex(v);
+	}
+
+	// return true if edge is in graph
+	bool isEdge(const Vertex &v, const Vertex &w) const {
+		return _D.isEdge(v, w);
+	}
+
+	// position of v in the order, positions are increasing but not dense
+	std::size_t ord(const Vertex &v) const {
+		assert(isVertex(v));
+		return _s.at(v).ord;
+	}
+
+	// true if v comes before w in the order
+	bool before(const Vertex &v, const Vertex &w) const {
+		return ord(v) < ord(w);
+	}
+
+	// return the vertices in topological order
+	std::list<Vertex> ts() const {
+		std::list<Vertex> ans;
+		for (auto *v : _at) {
+			if (v != nullptr) {
+				ans.push_back(*v);
+			}
+		}
+		return ans;
+	}
+
+	// return true and add vertex, last in the order, if not already in graph
+	bool addVertex(const Vertex &v) {
+		if (!_D.addVertex(v)) { return false; }
+
+		auto it = _s.emplace(v, State{_at.size(), 0}).first;
+		_at.push_back(&it->first);
+		return true;
+	}
+
+	// return true and add edge if not already in graph and it closes no
+	// cycle, reordering only the affected region
+	bool addEdge(const Vertex &v, const Vertex &w) {
+		if (!isVertex(v) || !isVertex(w) || v == w) { return false; }
+		if (isEdge(v, w)) { return false; }
+
+		std::size_t lb = ord(w), ub = ord(v);
+		if (lb < ub) {
+			_mark++;
+			if (!forward(w, ub)) {
+				return false;
+			}
+			backward(v, lb);
+			shuffle();
+		}
+		return _D.addEdge(v, w);
+	}
+
+	// removes edge if in graph, the order stays valid
+	void removeEdge(const Vertex &v, const Vertex &w) {
+		_D.removeEdge(v, w);
+	}
+
+	// removes vertex if in graph, its position is left empty until half of
+	// them are
+	void removeVertex(const Vertex &v) {
+		assert(isVertex(v));
+		_at[ord(v)] = nullptr;
+		_s.erase(v);
+		_D.removeVertex(v);
+		if (++_holes > _at.size()/2) {
+			compact();
+		}
+	}
+
+private:
+	// position in the order and last search that visited the vertex
+	struct State {
+		std::size_t ord, mark;
+	};
+
+	digraph<Vertex, Adjacency> _D;
+	std::unordered_map<Vertex, State> _s;
+	std::vector<const Vertex*> _at;			// position -> vertex, null if removed
+	std::size_t _mark, _holes;				// current search, empty positions
+
+	// scratch of one insertion, the positions and vertices found forward
+	// and backward
+	typedef std::pair<std::size_t, const Vertex*> Found;
+	std::vector<Found> _F, _B;
+	std::vector<const Vertex*> _stack;
+	std::vector<std::size_t> _pos;
+
+	// search from w the vertices ordered before ub, false if it reaches the
+	// vertex at ub (a cycle)
+	bool forward(const Vertex &w, std::size_t ub) {
+		_F.clear();
+		_stack.assign(1, &_s.find(w)->first);
+		_s.at(w).mark = _mark;
+		while (!_stack.empty()) {
+			const Vertex *u = _stack.back();
+			_stack.pop_back();
+			_F.emplace_back(_s.at(*u).ord, u);
+			STATS_ADD(dfs_vertices, 1);
+			for (auto &x : _D.Adj(*u)) {
+				STATS_ADD(dfs_edges, 1);
+				auto it = _s.find(x);
+				State &s = it->second;
+				if (s.ord == ub) {
+					return false;
+				}
+				if (s.mark != _mark && s.ord < ub) {
+					s.mark = _mark;
+					_stack.push_back(&it->first);
+				}
+			}
+		}
+		return true;
+	}
+
+	// search back from v the vertices ordered after lb, none was reached
+	// forward or the edge would close a cycle
+	void backward(const Vertex &v, std::size_t lb) {
+		_B.clear();
+		_stack.assign(1, &_s.find(v)->first);
+		_s.at(v).mark = _mark;
+		while (!_stack.empty()) {
+			const Vertex *u = _stack.back();
+			_stack.pop_back();
+			_B.emplace_back(_s.at(*u).ord, u);
+			STATS_ADD(dfs_vertices, 1);
+			for (auto &x : _D.InAdj(*u)) {
+				STATS_ADD(dfs_edges, 1);
+				auto it = _s.find(x);
+				State &s = it->second;
+				if (s.mark != _mark && s.ord > lb) {
+					s.mark = _mark;
+					_stack.push_back(&it->first);
+				}
+			}
+		}
+	}
+
+	// give the positions held by both searches to the backward vertices
+	// first and the forward ones after, each keeping its relative order
+	void shuffle() {
+		std::sort(_F.begin(), _F.end());
+		std::sort(_B.begin(), _B.end());
+
+		_pos.clear();
+		for (auto &f : _B) {
+			_pos.push_back(f.first);
+		}
+		for (auto &f : _F) {
+			_pos.push_back(f.first);
+		}
+		std::inplace_merge(_pos.begin(), _pos.begin() + _B.size(), _pos.end());
+
+		std::size_t i(0);
+		for (auto *group : {&_B, &_F}) {
+			for (auto &f : *group) {
+				_s.at(*f.second).ord = _pos[i];
+				_at[_pos[i++]] = f.second;
+			}
+		}
+	}
+
+	// close the empty positions, keeping the order
+	void compact() {
+		std::size_t k(0);
+		for (auto *v : _at) {
+			if (v != nullptr) {
+				_s.at(*v).ord = k;
+				_at[k++] = v;
+			}
+		}
+		_at.resize(k);
+		_holes = 0;
+	}
+
+};
+
+#endif // TOPO_H
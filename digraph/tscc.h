@@ -2,60 +2,176 @@
 #define TSCC_H
 
 #include <unordered_map>
+#include <memory_resource>
 #include <stack>
+#include <vector>
+#include <limits>
 
-template <class Vertex> class digraph;
+#include "../graph/arena.h"
+#include "../graph/csr.h"
+#include "../graph/packed.h"
+#include "../graph/stats.h"
+#include "../graph/adjacency.h"
 
 template <class Vertex>
 class TSCC {
+	template <class Set> struct Frame;
+	template <class It> struct DFrame;
+
 public:
-	TSCC(const digraph<Vertex> &D) {
+	typedef typename csr<Vertex>::Id Id;
+
+	template <class Adjacency>
+	TSCC(const digraph<Vertex, Adjacency> &D) {
+		STATS_PHASE("TSCC");
 		_ncc = _time = 0;
+		std::vector< Frame<typename digraph<Vertex, Adjacency>::VertexSet> > stack;
 		for (auto &v : D.V()) {
 			if (_pre.count(v) == 0) {
-				tdfs_one(D, v);
+				tdfs_one(D, v, stack);
 			}
 		}
 	}
 
-	void tdfs_one(const digraph<Vertex> &D, const Vertex &v) {
-		_pre[v] = _low[v] = _time++;
-		_S.push(v);
-		for (auto &w : D.Adj(v)) {
-			if (_pre.count(w) == 0) {
-				tdfs_one(D, w);
+	// iterative search, the explicit stack is reused between calls
+	template <class Adjacency, class Set>
+	void tdfs_one(const digraph<Vertex, Adjacency> &D, const Vertex &v, std::vector< Frame<Set> > &stack) {
+		enter(D, v, stack);
+
+		while (!stack.empty()) {
+			Frame<Set> &f = stack.back();
+			if (f.next != f.end) {
+				const Vertex &w = *(f.next++);
+				STATS_ADD(dfs_edges, 1);
+				if (_pre.count(w) == 0) {
+					enter(D, w, stack);
+				} else {
+					_low[f.v] = std::min(_low[f.v], _low[w]);
+				}
+				continue;
+			}
+
+			Vertex u = f.v;
+			stack.pop_back();
+
+			if (_pre[u] == _low[u]) {
+				Vertex top;
+				std::size_t inf = D.n();
+
+				do {
+					top = _S.top();
+					_S.pop();
+					_C[top] = _ncc;
+					_low[top] = inf;
+				} while(top != u);
+				_ncc++;
+			}
+
+			if (!stack.empty()) {
+				Vertex &p = stack.back().v;
+				_low[p] = std::min(_low[p], _low[u]);
+			}
+		}
+	}
+
+	// same algorithm on a csr snapshot, results are translated back to vertices
+	TSCC(const csr<Vertex> &D) {
+		STATS_PHASE("TSCC/csr");
+		search(D);
+	}
+
+	// same algorithm decoding the neighbor lists of a packed snapshot
+	TSCC(const packed_csr<Vertex> &D) {
+		STATS_PHASE("TSCC/packed");
+		search(D);
+	}
+
+	// find the components of every vertex of a snapshot
+	template <class Snapshot>
+	void search(const Snapshot &D) {
+		_ncc = _time = 0;
+		std::vector< DFrame<typename Snapshot::const_iterator> > stack;
+		_dpre.assign(D.n(), unvisited);
+		_dlow.assign(D.n(), 0);
+		_dC.assign(D.n(), 0);
+		_dS.reserve(D.n());
+
+		for (Id v = 0; v < D.n(); v++) {
+			if (_dpre[v] == unvisited) {
+				tdfs_one(D, v, stack);
 			}
+		}
 
-			_low[v] = std::min(_low[v], _low[w]);
+		_pre.reserve(D.n());
+		_low.reserve(D.n());
+		_C.reserve(D.n());
+		for (Id v = 0; v < D.n(); v++) {
+			_pre[D.vertex(v)] = _dpre[v];
+			_low[D.vertex(v)] = _dlow[v];
+			_C[D.vertex(v)] = _dC[v];
 		}
 
-		if (_pre[v] == _low[v]) {
-			Vertex top;
-			std::size_t inf = D.n();
-
-			do {
-				top = _S.top();
-				_S.pop();
-				_C[top] = _ncc;
-				_low[top] = inf;
-			} while(top != v);
-			_ncc++;
+		std::vector<std::size_t>().swap(_dpre);
+		std::vector<std::size_t>().swap(_dlow);
+		std::vector<std::size_t>().swap(_dC);
+		std::vector<Id>().swap(_dS);
+	}
+
+	// iterative search, the explicit stack is reused between calls
+	template <class Snapshot, class It>
+	void tdfs_one(const Snapshot &D, Id v, std::vector< DFrame<It> > &stack) {
+		enter(D, v, stack);
+
+		while (!stack.empty()) {
+			DFrame<It> &f = stack.back();
+			if (f.next != f.end) {
+				Id w = *f.next;
+				++f.next;
+				STATS_ADD(dfs_edges, 1);
+				if (_dpre[w] == unvisited) {
+					enter(D, w, stack);
+				} else {
+					_dlow[f.v] = std::min(_dlow[f.v], _dlow[w]);
+				}
+				continue;
+			}
+
+			Id u = f.v;
+			stack.pop_back();
+
+			if (_dpre[u] == _dlow[u]) {
+				Id top;
+				std::size_t inf = D.n();
+
+				do {
+					top = _dS.back();
+					_dS.pop_back();
+					_dC[top] = _ncc;
+					_dlow[top] = inf;
+				} while(top != u);
+				_ncc++;
+			}
+
+			if (!stack.empty()) {
+				Id p = stack.back().v;
+				_dlow[p] = std::min(_dlow[p], _dlow[u]);
+			}
 		}
 	}
 
 	// pre times for each vertex
 	std::unordered_map<Vertex, std::size_t> pre() const {
-		return _pre;
+		return std::unordered_map<Vertex, std::size_t>(_pre.begin(), _pre.end());
 	}
 
 	// low times for each vertex
 	std::unordered_map<Vertex, std::size_t> low() const {
-		return _low;
+		return std::unordered_map<Vertex, std::size_t>(_low.begin(), _low.end());
 	}
 
 	// component ids for each vertex
 	std::unordered_map<Vertex, std::size_t> components() const {
-		return _C;
+		return std::unordered_map<Vertex, std::size_t>(_C.begin(), _C.end());
 	}
 
 	// number of connected components
@@ -64,10 +180,51 @@ public:
 	}
 
 private:
-	std::unordered_map<Vertex, std::size_t> _pre, _low, _C;
+	// vertex maps of a run come from one arena, freed together with it
+	arena_ptr _arena;
+	std::pmr::unordered_map<Vertex, std::size_t> _pre{_arena.get()}, _low{_arena.get()}, _C{_arena.get()};
 	std::size_t _time, _ncc;
 	std::stack<Vertex> _S;
 
+	// explicit stack frame, a vertex and its next unexplored neighbor
+	template <class Set>
+	struct Frame {
+		Vertex v;
+		typename Set::const_iterator next, end;
+	};
+
+	static constexpr std::size_t unvisited = std::numeric_limits<std::size_t>::max();
+
+	// dense state of a csr search, indexed by id
+	std::vector<std::size_t> _dpre, _dlow, _dC;
+	std::vector<Id> _dS;
+
+	// snapshot stack frame, a vertex id and its next unexplored neighbor
+	template <class It>
+	struct DFrame {
+		Id v;
+		It next, end;
+	};
+
+	// number v and push it on both stacks
+	template <class Adjacency, class Set>
+	void enter(const digraph<Vertex, Adjacency> &D, const Vertex &v, std::vector< Frame<Set> > &stack) {
+		_pre[v] = _low[v] = _time++;
+		_S.push(v);
+		STATS_ADD(dfs_vertices, 1);
+		const Set &adj = D.Adj(v);
+		stack.push_back(Frame<Set>{v, adj.begin(), adj.end()});
+	}
+
+	template <class Snapshot, class It>
+	void enter(const Snapshot &D, Id v, std::vector< DFrame<It> > &stack) {
+		_dpre[v] = _dlow[v] = _time++;
+		_dS.push_back(v);
+		STATS_ADD(dfs_vertices, 1);
+		typename Snapshot::Range adj = D.Adj(v);
+		stack.push_back(DFrame<It>{v, adj.begin(), adj.end()});
+	}
+
 };
 
 #endif // TSCC_H
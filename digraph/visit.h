@@ -0,0 +1,212 @@
+#ifndef VISIT_H
+#define VISIT_H
+
+#include <memory_resource>
+#include <unordered_map>
+#include <list>
+#include <vector>
+#include <limits>
+
+#include "../graph/arena.h"
+#include "../graph/csr.h"
+#include "../graph/stats.h"
+#include "../graph/adjacency.h"
+
+// hooks of depth_first, all doing nothing; a visitor derives from this and
+// hides the hooks it needs, which are bound at compile time, and stop()
+// is checked after every hook to end the search early
+//
+//   struct count_back : dfs_visitor<int> {
+//       std::size_t k = 0;
+//       void on_back_edge(const int&, const int&) { k++; }
+//   };
+//
+// edges are classified as they are explored: to an unvisited vertex is a
+// tree edge, to a vertex still on the stack a back edge, to a finished
+// vertex discovered later a forward edge and to any other a cross edge
+template <class Vertex>
+struct dfs_visitor {
+	void on_start(const Vertex&) { }					// root of a new tree
+	void on_discover(const Vertex&) { }
+	void on_tree_edge(const Vertex&, const Vertex&) { }
+	void on_back_edge(const Vertex&, const Vertex&) { }
+	void on_forward_edge(const Vertex&, const Vertex&) { }
+	void on_cross_edge(const Vertex&, const Vertex&) { }
+	void on_finish(const Vertex&) { }
+	bool stop() const { return false; }
+};
+
+// stops at the first back edge, cyclic is true if there was one
+template <class Vertex>
+struct cycle_visitor : dfs_visitor<Vertex> {
+	bool cyclic = false;
+
+	void on_back_edge(const Vertex&, const Vertex&) {
+		cyclic = true;
+	}
+
+	bool stop() const {
+		return cyclic;
+	}
+};
+
+// vertices in reverse finish order, a topological order unless cyclic
+template <class Vertex>
+struct topological_visitor : cycle_visitor<Vertex> {
+	std::list<Vertex> order;
+
+	void on_finish(const Vertex &v) {
+		order.push_front(v);
+	}
+};
+
+// depth first search of D calling the hooks of vis, from the vertices of
+// V in order and then from any unvisited vertex; returns false if the
+// visitor stopped it
+template <class Vertex, class Adjacency, class Visitor>
+bool depth_first(const digraph<Vertex, Adjacency> &D, Visitor &vis, const std::list<Vertex> &V = std::list<Vertex>()) {
+	typedef typename digraph<Vertex, Adjacency>::VertexSet Set;
+	STATS_PHASE("depth_first");
+
+	// explicit stack frame, a vertex and its next unexplored neighbor
+	struct Frame {
+		const Vertex *v;
+		typename Set::const_iterator next, end;
+	};
+
+	// pre number of every discovered vertex and whether it is on the stack
+	struct State {
+		std::size_t pre;
+		bool open;
+	};
+
+	arena a;
+	std::pmr::unordered_map<Vertex, State> S(&a);
+	S.reserve(D.n());
+	std::vector<Frame> stack;
+	std::size_t time(0);
+
+	auto enter = [&](const Vertex &v) {
+		auto it = S.emplace(v, State{time++, true}).first;
+		STATS_ADD(dfs_vertices, 1);
+		const Set &adj = D.Adj(v);
+		stack.push_back(Frame{&it->first, adj.begin(), adj.end()});
+		vis.on_discover(v);
+	};
+
+	auto search = [&](const Vertex &r) {
+		vis.on_start(r);
+		enter(r);
+		if (vis.stop()) {
+			return false;
+		}
+
+		while (!stack.empty()) {
+			Frame &f = stack.back();
+			if (f.next == f.end) {
+				const Vertex &v = *f.v;
+				S.find(v)->second.open = false;
+				stack.pop_back();
+				vis.on_finish(v);
+			} else {
+				const Vertex &v = *f.v, &w = *(f.next++);
+				STATS_ADD(dfs_edges, 1);
+				auto it = S.find(w);
+				if (it == S.end()) {
+					vis.on_tree_edge(v, w);
+					enter(w);
+				} else if (it->second.open) {
+					vis.on_back_edge(v, w);
+				} else if (S.find(v)->second.pre < it->second.pre) {
+					vis.on_forward_edge(v, w);
+				} else {
+					vis.on_cross_edge(v, w);
+				}
+			}
+			if (vis.stop()) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	for (auto &v : V) {
+		if (D.isVertex(v) && S.count(v) == 0 && !search(v)) {
+			return false;
+		}
+	}
+	for (auto &v : D.V()) {
+		if (S.count(v) == 0 && !search(v)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// same search of a csr snapshot in id order, the hooks get vertex ids
+template <class Vertex, class Visitor>
+bool depth_first(const csr<Vertex> &D, Visitor &vis) {
+	typedef typename csr<Vertex>::Id Id;
+	const std::size_t inf = std::numeric_limits<std::size_t>::max();
+	STATS_PHASE("depth_first/csr");
+
+	// csr stack frame, a vertex id and its next unexplored neighbor
+	struct Frame {
+		Id v;
+		const Id *next, *end;
+	};
+
+	std::vector<std::size_t> pre(D.n(), inf);
+	std::vector<bool> open(D.n(), false);
+	std::vector<Frame> stack;
+	std::size_t time(0);
+
+	auto enter = [&](Id v) {
+		pre[v] = time++;
+		open[v] = true;
+		STATS_ADD(dfs_vertices, 1);
+		typename csr<Vertex>::Range adj = D.Adj(v);
+		stack.push_back(Frame{v, adj.begin(), adj.end()});
+		vis.on_discover(v);
+	};
+
+	for (Id r = 0; r < D.n(); r++) {
+		if (pre[r] != inf) {
+			continue;
+		}
+		vis.on_start(r);
+		enter(r);
+		if (vis.stop()) {
+			return false;
+		}
+
+		while (!stack.empty()) {
+			Frame &f = stack.back();
+			if (f.next == f.end) {
+				Id v = f.v;
+				open[v] = false;
+				stack.pop_back();
+				vis.on_finish(v);
+			} else {
+				Id v = f.v, w = *(f.next++);
+				STATS_ADD(dfs_edges, 1);
+				if (pre[w] == inf) {
+					vis.on_tree_edge(v, w);
+					enter(w);
+				} else if (open[w]) {
+					vis.on_back_edge(v, w);
+				} else if (pre[v] < pre[w]) {
+					vis.on_forward_edge(v, w);
+				} else {
+					vis.on_cross_edge(v, w);
+				}
+			}
+			if (vis.stop()) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+#endif // VISIT_H
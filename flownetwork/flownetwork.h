@@ -116,7 +116,9 @@ public:
 		double w(std::numeric_limits<double>::infinity());
 		for (T v = _sink; v != _source; v = parent.at(v)) {
 			w = std::min(w, network<T>::cost(parent.at(v), v));
+			STATS_ADD(augmenting_path_edges, 1);
 		}
+		STATS_ADD(augmenting_paths, 1);
 
 		// create a flow on this path with flow value w
 		flow<T> ans(_source, _sink);
@@ -139,7 +141,7 @@ public:
 			}
 
 			if (network<T>::isEdge(v, p)) {
-				network<T>::setCost(v, p, network<T>::cost(p,v)+w);
+				network<T>::setCost(v, p, network<T>::cost(v, p)+w);
 			} else {
 				network<T>::addEdge(v, p, w);
 			}
@@ -150,6 +152,7 @@ public:
 
     // return the max flow using Edmonds-Karp algorithm (Ford-Fulkerson algorithm)
 	flow<T> max_flow() const {
+		STATS_PHASE("max_flow");
 		flownetwork<T> residual(*this);
 		flow<T> ans(_source, _sink);
 
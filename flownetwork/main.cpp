@@ -2,13 +2,14 @@
 #include <fstream>
 #include <cassert>
 
+#include "../graph/symbol.h"
 #include "flownetwork.h"
 
 using namespace std;
 
 int main() {
-	flownetwork<string> F("s","t");
+	flownetwork<symbol> F("s","t");
 	cin >> F;
 
-	flow<string> mf = F.max_flow();
+	flow<symbol> mf = F.max_flow();
 }
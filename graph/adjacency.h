@@ -0,0 +1,37 @@
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include <unordered_set>
+#include <memory_resource>
+
+#include "small_set.h"
+
+// adjacency policies of graph and digraph, each names the set type holding
+// the neighbors of one vertex and whether a digraph also keeps in neighbors
+
+// hash set per vertex
+struct hash_adjacency {
+	template <class Vertex>
+	using set = std::pmr::unordered_set<Vertex>;
+	static constexpr bool in_edges = false;
+};
+
+// small inline set per vertex, far less memory when most degrees are low
+struct small_adjacency {
+	template <class Vertex>
+	using set = small_set<Vertex>;
+	static constexpr bool in_edges = false;
+};
+
+// a policy whose digraphs also keep the set of in neighbors of every
+// vertex, for O(1) indeg, InAdj and transpose; graphs ignore it
+template <class Adjacency = hash_adjacency>
+struct bidirectional : Adjacency {
+	static constexpr bool in_edges = true;
+};
+
+template <class Vertex, class Adjacency = hash_adjacency> class graph;
+template <class Vertex, class Adjacency = hash_adjacency> class digraph;
+template <class Vertex, class Adjacency> class transpose_view;
+
+#endif // ADJACENCY_H
@@ -0,0 +1,143 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <memory_resource>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// monotonic arena for allocator aware containers (std::pmr): hands out
+// memory by bumping a cursor through geometrically growing blocks and
+// frees it all at once in release() or the destructor
+//
+//   arena a;
+//   graph<int> G(&a);		// adjacency nodes come from a
+//
+// deallocate is a no-op, so erasing from a container never returns memory
+// to the arena; put a std::pmr::unsynchronized_pool_resource on top of the
+// arena to recycle freed nodes in graphs that shrink. containers using the
+// arena must be destroyed before it, and it is not thread safe
+class arena : public std::pmr::memory_resource {
+public:
+	explicit arena(std::size_t block = min_block,
+			std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+		: _up(upstream), _head(nullptr), _cur(nullptr), _end(nullptr),
+		  _first(std::max(block, min_block)), _next(_first), _allocated(0), _reserved(0) { }
+
+	arena(const arena&) = delete;
+	arena& operator = (const arena&) = delete;
+
+	~arena() {
+		release();
+	}
+
+	// return every block upstream, any memory handed out is invalid after
+	void release() {
+		while (_head != nullptr) {
+			block *b = _head;
+			_head = b->next;
+			_up->deallocate(b, b->size, alignof(std::max_align_t));
+		}
+		_cur = _end = nullptr;
+		_next = _first;
+		_allocated = _reserved = 0;
+	}
+
+	// bytes handed out since the last release
+	std::size_t allocated() const {
+		return _allocated;
+	}
+
+	// bytes held in blocks
+	std::size_t reserved() const {
+		return _reserved;
+	}
+
+private:
+	static constexpr std::size_t min_block = 1 << 12;
+	static constexpr std::size_t max_block = 1 << 26;		// growth stops doubling here
+
+	struct alignas(std::max_align_t) block {
+		block *next;
+		std::size_t size;
+	};
+
+	std::pmr::memory_resource *_up;
+	block *_head;							// newest block first
+	char *_cur, *_end;						// free space of the newest block
+	std::size_t _first, _next;				// sizes of the first and next block
+	std::size_t _allocated, _reserved;
+
+	void* do_allocate(std::size_t bytes, std::size_t align) override {
+		std::size_t pad = -reinterpret_cast<std::uintptr_t>(_cur) & (align - 1);
+		if (_cur == nullptr || pad + bytes > std::size_t(_end - _cur)) {
+			grow(bytes + align);
+			pad = -reinterpret_cast<std::uintptr_t>(_cur) & (align - 1);
+		}
+
+		void *ans = _cur + pad;
+		_cur += pad + bytes;
+		_allocated += bytes;
+		return ans;
+	}
+
+	// freed with the whole arena
+	void do_deallocate(void*, std::size_t, std::size_t) override { }
+
+	bool do_is_equal(const std::pmr::memory_resource &o) const noexcept override {
+		return this == &o;
+	}
+
+	// start a block with room for at least bytes
+	void grow(std::size_t bytes) {
+		std::size_t size = std::max(_next, sizeof(block) + bytes);
+		block *b = ::new (_up->allocate(size, alignof(std::max_align_t))) block{_head, size};
+		_head = b;
+		_cur = reinterpret_cast<char*>(b + 1);
+		_end = reinterpret_cast<char*>(b) + size;
+		_reserved += size;
+		_next = std::min(2*_next, max_block);
+	}
+
+};
+
+// arena shared by a class and the pmr members allocating from it. pmr
+// containers keep the allocator they were built with: a move constructed
+// one takes the source's arena, a copy constructed one the default
+// resource, and an assigned one keeps its own. so every object built on
+// an arena holds a reference to it, moves and copies share it, and an
+// assignment keeps the arena of the target; the defaulted copy, move and
+// swap of the class then never leave a container on a freed arena
+//
+//   arena_ptr _arena;
+//   std::pmr::unordered_map<int, int> _D{_arena.get()};
+//
+// an arena only grows, so repeated assignment into one object keeps the
+// memory of every value it held until the last sharer is destroyed
+class arena_ptr {
+public:
+	arena_ptr() : _a(std::make_shared<arena>()) { }
+
+	arena_ptr(const arena_ptr&) = default;
+	arena_ptr(arena_ptr &&o) : _a(o._a) { }
+
+	arena_ptr& operator = (const arena_ptr&) {
+		return *this;
+	}
+
+	arena_ptr& operator = (arena_ptr&&) {
+		return *this;
+	}
+
+	arena* get() const {
+		return _a.get();
+	}
+
+private:
+	std::shared_ptr<arena> _a;
+
+};
+
+#endif // ARENA_H
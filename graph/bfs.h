@@ -2,14 +2,27 @@
 #define BFS_H
 
 #include <unordered_map>
+#include <memory_resource>
 #include <queue>
+#include <vector>
+#include <limits>
+#include <cassert>
 
-template <class Vertex> class graph;
+#include "arena.h"
+#include "csr.h"
+#include "packed.h"
+#include "bitmap.h"
+#include "stats.h"
+#include "adjacency.h"
 
 template <class Vertex>
 class BFS {
 public:
-	BFS(const graph<Vertex> &G, const Vertex &start = Vertex()) {
+	typedef typename csr<Vertex>::Id Id;
+
+	template <class Adjacency>
+	BFS(const graph<Vertex, Adjacency> &G, const Vertex &start = Vertex()) {
+		STATS_PHASE("BFS");
 		_ncc = 0;
 
 		if (G.isVertex(start)) {
@@ -25,7 +38,8 @@ public:
 		}
 	}
 
-	void bfs_one(const graph<Vertex> &G, const Vertex &v) {
+	template <class Adjacency>
+	void bfs_one(const graph<Vertex, Adjacency> &G, const Vertex &v) {
 		std::queue<Vertex> Q;
 		Q.push(v);
 		_D[v] = 0;
@@ -34,8 +48,10 @@ public:
 		while (!Q.empty()) {
 			Vertex f = Q.front();
 			Q.pop();
+			STATS_ADD(bfs_vertices, 1);
 
 			for (auto &w : G.Adj(f)) {
+				STATS_ADD(bfs_edges, 1);
 				if (_D.count(w) == 0) {
 					Q.push(w);
 					_D[w] = 1 + _D[f];
@@ -46,19 +62,128 @@ public:
 		}
 	}
 
+	// same search on an undirected csr snapshot, results are translated back
+	// to vertices
+	BFS(const csr<Vertex> &G, const Vertex &start = Vertex()) {
+		STATS_PHASE("BFS/csr");
+		search(G, start);
+	}
+
+	// same search decoding the neighbor lists of an undirected packed snapshot
+	BFS(const packed_csr<Vertex> &G, const Vertex &start = Vertex()) {
+		STATS_PHASE("BFS/packed");
+		search(G, start);
+	}
+
+	// search every component of a snapshot, starting with start; the bottom
+	// up step looks for a parent among out neighbors, so the snapshot must
+	// be undirected
+	template <class Snapshot>
+	void search(const Snapshot &G, const Vertex &start) {
+		assert(!G.directed());
+		_ncc = 0;
+		_dD.assign(G.n(), inf);
+		_dC.assign(G.n(), 0);
+		_dP.assign(G.n(), csr<Vertex>::none);
+		_visited.assign(G.n());
+		_fbits.assign(G.n());
+		_nbits.assign(G.n());
+		_mu = G.arcs();
+
+		if (G.isVertex(start)) {
+			bfs_one(G, G.id(start));
+			_ncc++;
+		}
+
+		for (Id v = 0; v < G.n(); v++) {
+			if (_dD[v] == inf) {
+				bfs_one(G, v);
+				_ncc++;
+			}
+		}
+
+		translate(G);
+	}
+
+	// direction optimizing search (Beamer et al.), expands the frontier
+	// top down while it is small and switches to bottom up parent search
+	// while the frontier holds a large share of the unexplored edges
+	template <class Snapshot>
+	void bfs_one(const Snapshot &G, Id v) {
+		std::size_t depth(0), mf(G.deg(v)), nf(1);
+		bool bottomUp(false);
+
+		visit(G, v, csr<Vertex>::none, 0);
+		_front.assign(1, v);
+
+		while (nf > 0) {
+			if (!bottomUp && mf > _mu/alpha) {
+				bottomUp = true;
+				_fbits.clear();
+				for (Id f : _front) {
+					_fbits.set(f);
+				}
+			} else if (bottomUp && nf < G.n()/beta) {
+				bottomUp = false;
+				_front.clear();
+				for (Id f = 0; f < G.n(); f++) {
+					if (_fbits.test(f)) {
+						_front.push_back(f);
+					}
+				}
+			}
+
+			mf = nf = 0;
+			depth++;
+			if (bottomUp) {
+				_nbits.clear();
+				for (Id u = 0; u < G.n(); u++) {
+					if (_visited.test(u)) {
+						continue;
+					}
+					for (Id w : G.Adj(u)) {
+						STATS_ADD(bfs_edges, 1);
+						if (_fbits.test(w)) {
+							visit(G, u, w, depth);
+							_nbits.set(u);
+							mf += G.deg(u);
+							nf++;
+							break;
+						}
+					}
+				}
+				std::swap(_fbits, _nbits);
+			} else {
+				_next.clear();
+				for (Id f : _front) {
+					for (Id w : G.Adj(f)) {
+						STATS_ADD(bfs_edges, 1);
+						if (!_visited.test(w)) {
+							visit(G, w, f, depth);
+							_next.push_back(w);
+							mf += G.deg(w);
+						}
+					}
+				}
+				nf = _next.size();
+				std::swap(_front, _next);
+			}
+		}
+	}
+
 	// distances of each vertex to root of component
 	std::unordered_map<Vertex, std::size_t> distances() const {
-		return _D;
+		return std::unordered_map<Vertex, std::size_t>(_D.begin(), _D.end());
 	}
 
 	// parents of each vertex in Breadth First Tree
 	std::unordered_map<Vertex, Vertex> bfTree() const {
-		return _P;
+		return std::unordered_map<Vertex, Vertex>(_P.begin(), _P.end());
 	}
 
 	// component ids for each vertex
 	std::unordered_map<Vertex, std::size_t> components() const {
-		return _C;
+		return std::unordered_map<Vertex, std::size_t>(_C.begin(), _C.end());
 	}
 
 	// number of connected components
@@ -67,9 +192,58 @@ public:
 	}
 
 private:
+	static constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+
 	std::size_t _ncc;
-	std::unordered_map<Vertex, std::size_t> _D, _C;
-	std::unordered_map<Vertex, Vertex> _P;
+
+	// vertex maps of a run come from one arena, freed together with it
+	arena_ptr _arena;
+	std::pmr::unordered_map<Vertex, std::size_t> _D{_arena.get()}, _C{_arena.get()};
+	std::pmr::unordered_map<Vertex, Vertex> _P{_arena.get()};
+
+	// switching thresholds for direction optimizing search
+	static constexpr std::size_t alpha = 15, beta = 18;
+
+	// dense state of a csr search, indexed by id
+	std::vector<std::size_t> _dD, _dC;
+	std::vector<Id> _dP, _front, _next;
+	bitmap _visited, _fbits, _nbits;		// visited set and frontier bitmaps
+	std::size_t _mu;						// edges out of unvisited vertices
+
+	// mark v as reached from parent p at distance d
+	template <class Snapshot>
+	void visit(const Snapshot &G, Id v, Id p, std::size_t d) {
+		_visited.set(v);
+		_dD[v] = d;
+		_dP[v] = p;
+		_dC[v] = _ncc;
+		_mu -= G.deg(v);
+		STATS_ADD(bfs_vertices, 1);
+	}
+
+	// copy dense state into the vertex maps and release it
+	template <class Snapshot>
+	void translate(const Snapshot &G) {
+		_D.reserve(G.n());
+		_C.reserve(G.n());
+		_P.reserve(G.n());
+		for (Id v = 0; v < G.n(); v++) {
+			_D[G.vertex(v)] = _dD[v];
+			_C[G.vertex(v)] = _dC[v];
+			if (_dP[v] != csr<Vertex>::none) {
+				_P[G.vertex(v)] = G.vertex(_dP[v]);
+			}
+		}
+
+		std::vector<std::size_t>().swap(_dD);
+		std::vector<std::size_t>().swap(_dC);
+		std::vector<Id>().swap(_dP);
+		std::vector<Id>().swap(_front);
+		std::vector<Id>().swap(_next);
+		_visited.assign(0);
+		_fbits.assign(0);
+		_nbits.assign(0);
+	}
 
 };
 
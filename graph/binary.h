@@ -0,0 +1,329 @@
+#ifndef BINARY_H
+#define BINARY_H
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <cassert>
+
+#include "csr.h"
+#include "view.h"
+#include "mapped_file.h"
+#include "parse.h"
+
+// binary graph file, version 1, native (little endian) byte order
+//
+//   header
+//   offsets          uint64[n+1]
+//   targets          uint32[arcs], padded to 8 bytes
+//   costs            double[arcs], only if weighted
+//   label offsets    uint64[n+1]
+//   label bytes      char[label_bytes]
+//
+// offsets and targets are a csr snapshot, an undirected kind stores every
+// edge in both directions and costs[a] is the cost of arc a
+
+// kinds of graph held in a binary file
+enum class graph_kind : std::uint32_t {
+	graph = 0, digraph = 1, wgraph = 2, network = 3, flownetwork = 4
+};
+
+// true if kind stores every edge in both directions
+inline bool isUndirected(graph_kind k) {
+	return (k == graph_kind::graph || k == graph_kind::wgraph);
+}
+
+// true if kind has a cost per edge
+inline bool isWeighted(graph_kind k) {
+	return (k != graph_kind::graph && k != graph_kind::digraph);
+}
+
+struct binary_header {
+	char magic[8];					// "GRAPHBIN"
+	std::uint32_t version;
+	std::uint32_t kind;				// graph_kind
+	std::uint64_t n;				// vertices
+	std::uint64_t arcs;				// stored neighbor entries
+	std::uint64_t loops;			// self loops
+	std::uint64_t label_bytes;
+	std::uint32_t source, sink;		// flownetwork terminal ids
+	std::uint64_t reserved;
+};
+
+static_assert(sizeof(binary_header) == 64, "binary_header must be 64 bytes");
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "offsets are mapped as std::size_t");
+
+const char binary_magic[8] = {'G', 'R', 'A', 'P', 'H', 'B', 'I', 'N'};
+const std::uint32_t binary_version = 1;
+
+// section sizes rounded up to keep every array 8 byte aligned
+inline std::size_t binary_pad(std::size_t bytes) {
+	return (bytes + 7) & ~std::size_t(7);
+}
+
+// file positions of the sections of a file, found from its header
+struct binary_layout {
+	std::size_t off, adj, cost, loff, lbytes, end;
+
+	// return true if the header is of a known version and kind and every
+	// section it declares fits in a file of size bytes; the sizes are
+	// checked against the bytes left, so a corrupt count cannot wrap
+	bool locate(const binary_header &h, std::size_t size) {
+		if (std::memcmp(h.magic, binary_magic, sizeof(h.magic)) != 0
+			|| h.version != binary_version || h.kind > std::uint32_t(graph_kind::flownetwork)
+			|| h.n >= std::numeric_limits<std::uint32_t>::max() || h.arcs < h.loops
+			|| (h.kind == std::uint32_t(graph_kind::flownetwork) && (h.source >= h.n || h.sink >= h.n))) {
+			return false;
+		}
+
+		std::size_t at = sizeof(binary_header);
+		auto skip = [&](std::uint64_t count, std::size_t bytes) {
+			if (at > size || count > (size - at)/bytes) {
+				return false;
+			}
+			at += count*bytes;
+			return true;
+		};
+
+		off = at;
+		if (!skip(h.n + 1, sizeof(std::uint64_t))) {
+			return false;
+		}
+		adj = at;
+		if (!skip(h.arcs, sizeof(std::uint32_t))) {
+			return false;
+		}
+		at = binary_pad(at);
+		cost = at;
+		if (isWeighted(graph_kind(h.kind)) && !skip(h.arcs, sizeof(double))) {
+			return false;
+		}
+		loff = at;
+		if (!skip(h.n + 1, sizeof(std::uint64_t))) {
+			return false;
+		}
+		lbytes = at;
+		if (!skip(h.label_bytes, 1)) {
+			return false;
+		}
+		end = at;
+		return true;
+	}
+};
+
+// true if offsets o[0..n] start at 0, never decrease and end at last
+template <class Offset>
+bool binary_offsets(const Offset *o, std::size_t n, std::uint64_t last) {
+	if (o[0] != 0 || o[n] != last) {
+		return false;
+	}
+	for (std::size_t v = 0; v < n; v++) {
+		if (o[v] > o[v+1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// true if every target in [first, last) is a vertex id below n, found
+// from their maximum so the loop has no branch
+inline bool binary_targets(const std::uint32_t *first, const std::uint32_t *last, std::size_t n) {
+	std::uint32_t hi(0);
+	for (const std::uint32_t *t = first; t != last; t++) {
+		hi = std::max(hi, *t);
+	}
+	return first == last || hi < n;
+}
+
+// write csr snapshot S of the given kind, cost[a] is the cost of arc a and
+// source and sink are ids of the terminals of a flownetwork
+template <class Vertex>
+bool save_binary(const std::string &path, const csr<Vertex> &S, graph_kind kind,
+	const std::vector<double> &cost = std::vector<double>(),
+	typename csr<Vertex>::Id source = csr<Vertex>::none, typename csr<Vertex>::Id sink = csr<Vertex>::none) {
+	assert(S.directed() != isUndirected(kind));
+	assert(!isWeighted(kind) || cost.size() == S.arcs());
+	assert((kind == graph_kind::flownetwork) == (source != csr<Vertex>::none));
+
+	std::vector<std::uint64_t> loff(1, 0);
+	std::string lbytes;
+	for (auto &v : S.labels()) {
+		std::ostringstream os;
+		os << v;
+		lbytes += os.str();
+		loff.push_back(lbytes.size());
+	}
+
+	binary_header h;
+	std::memset(&h, 0, sizeof(h));
+	std::memcpy(h.magic, binary_magic, sizeof(h.magic));
+	h.version = binary_version;
+	h.kind = static_cast<std::uint32_t>(kind);
+	h.n = S.n();
+	h.arcs = S.arcs();
+	h.loops = S.loops();
+	h.label_bytes = lbytes.size();
+	h.source = source;
+	h.sink = sink;
+
+	std::ofstream os(path, std::ios::binary | std::ios::trunc);
+	const char zero[8] = {0};
+	std::size_t tbytes = S.arcs()*sizeof(typename csr<Vertex>::Id);
+
+	os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	os.write(reinterpret_cast<const char*>(S.offsets().data()), (S.n()+1)*sizeof(std::uint64_t));
+	os.write(reinterpret_cast<const char*>(S.targets().data()), tbytes);
+	os.write(zero, binary_pad(tbytes) - tbytes);
+	if (isWeighted(kind)) {
+		os.write(reinterpret_cast<const char*>(cost.data()), cost.size()*sizeof(double));
+	}
+	os.write(reinterpret_cast<const char*>(loff.data()), loff.size()*sizeof(std::uint64_t));
+	os.write(lbytes.data(), lbytes.size());
+
+	return bool(os);
+}
+
+// cost of every arc of S taken from weighted graph W
+template <class Vertex, class Weighted>
+std::vector<double> arc_costs(const csr<Vertex> &S, const Weighted &W) {
+	std::vector<double> ans;
+	ans.reserve(S.arcs());
+	for (typename csr<Vertex>::Id v = 0; v < S.n(); v++) {
+		for (auto w : S.Adj(v)) {
+			ans.push_back(W.cost(S.vertex(v), S.vertex(w)));
+		}
+	}
+	return ans;
+}
+
+// binary graph file mapped read only into memory, every array is used in
+// place so opening costs one pass checking them and no copy
+class mapped_graph {
+public:
+	typedef std::uint32_t Id;
+
+	mapped_graph() : _h(nullptr) { }
+
+	// return true if path was mapped and holds a valid file: the sections
+	// fit in it, offsets never decrease and every target is a vertex
+	bool open(const std::string &path) {
+		_h = nullptr;
+		_map = mapped_file::open(path);
+		if (!_map || _map->size() < sizeof(binary_header)) {
+			_map.reset();
+			return false;
+		}
+		const char *p = _map->data();
+		const binary_header *h = reinterpret_cast<const binary_header*>(p);
+		binary_layout L;
+		if (!L.locate(*h, _map->size())) {
+			_map.reset();
+			return false;
+		}
+
+		_off = reinterpret_cast<const std::size_t*>(p + L.off);
+		_adj = reinterpret_cast<const Id*>(p + L.adj);
+		_cost = isWeighted(graph_kind(h->kind)) ? reinterpret_cast<const double*>(p + L.cost) : nullptr;
+		_loff = reinterpret_cast<const std::uint64_t*>(p + L.loff);
+		_lbytes = p + L.lbytes;
+
+		if (!binary_offsets(_off, h->n, h->arcs) || !binary_targets(_adj, _adj + h->arcs, h->n)
+			|| !binary_offsets(_loff, h->n, h->label_bytes)) {
+			_map.reset();
+			return false;
+		}
+
+		_h = h;
+		return true;
+	}
+
+	// true if a file is mapped
+	bool isOpen() const {
+		return _h != nullptr;
+	}
+
+	graph_kind kind() const {
+		assert(isOpen());
+		return graph_kind(_h->kind);
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		assert(isOpen());
+		return _h->n;
+	}
+
+	// number of stored neighbor entries
+	std::size_t arcs() const {
+		assert(isOpen());
+		return _h->arcs;
+	}
+
+	// offsets into targets(), size n()+1
+	array_view<std::size_t> offsets() const {
+		assert(isOpen());
+		return array_view<std::size_t>(_off, n()+1);
+	}
+
+	// concatenated sorted neighbor lists
+	array_view<Id> targets() const {
+		assert(isOpen());
+		return array_view<Id>(_adj, arcs());
+	}
+
+	// cost of each arc, empty if not weighted
+	array_view<double> costs() const {
+		assert(isOpen());
+		return array_view<double>(_cost, _cost ? arcs() : 0);
+	}
+
+	// label of vertex id
+	std::string_view label(Id v) const {
+		assert(v < n());
+		return std::string_view(_lbytes + _loff[v], _loff[v+1] - _loff[v]);
+	}
+
+	// flownetwork source id
+	Id source() const {
+		assert(kind() == graph_kind::flownetwork);
+		return _h->source;
+	}
+
+	// flownetwork sink id
+	Id sink() const {
+		assert(kind() == graph_kind::flownetwork);
+		return _h->sink;
+	}
+
+	// csr snapshot over the mapped arrays, only the labels are converted;
+	// the snapshot keeps the file mapped
+	template <class Vertex>
+	csr<Vertex> snapshot() const {
+		assert(isOpen());
+		std::vector<Vertex> labels;
+		labels.reserve(n());
+		for (Id v = 0; v < n(); v++) {
+			labels.push_back(parse_label<Vertex>(label(v)));
+		}
+		return csr<Vertex>(std::move(labels), _off, _adj, !isUndirected(kind()), _h->loops, _map);
+	}
+
+private:
+	std::shared_ptr<mapped_file> _map;
+	const binary_header *_h;
+	const std::size_t *_off;
+	const Id *_adj;
+	const double *_cost;
+	const std::uint64_t *_loff;
+	const char *_lbytes;
+
+};
+
+#endif // BINARY_H
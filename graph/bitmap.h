@@ -0,0 +1,74 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+// fixed size set of dense ids stored one bit per id
+class bitmap {
+public:
+	typedef std::uint64_t word;
+
+	bitmap(std::size_t n = 0) : _n(n), _w((n + 63)/64, 0) { }
+
+	// number of bits
+	std::size_t size() const {
+		return _n;
+	}
+
+	// return true if bit i is set
+	bool test(std::size_t i) const {
+		assert(i < _n);
+		return (_w[i >> 6] >> (i & 63)) & 1;
+	}
+
+	// set bit i
+	void set(std::size_t i) {
+		assert(i < _n);
+		_w[i >> 6] |= word(1) << (i & 63);
+	}
+
+	// clear bit i
+	void reset(std::size_t i) {
+		assert(i < _n);
+		_w[i >> 6] &= ~(word(1) << (i & 63));
+	}
+
+	// clear all bits
+	void clear() {
+		std::fill(_w.begin(), _w.end(), 0);
+	}
+
+	// resize and clear all bits
+	void assign(std::size_t n) {
+		_n = n;
+		_w.assign((n + 63)/64, 0);
+	}
+
+	// number of set bits
+	std::size_t count() const {
+		std::size_t ans(0);
+		for (word x : _w) {
+			ans += __builtin_popcountll(x);
+		}
+		return ans;
+	}
+
+	// underlying words, bit i is bit i%64 of word i/64
+	const std::vector<word>& words() const {
+		return _w;
+	}
+
+	std::vector<word>& words() {
+		return _w;
+	}
+
+private:
+	std::size_t _n;
+	std::vector<word> _w;
+
+};
+
+#endif // BITMAP_H
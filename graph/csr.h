@@ -0,0 +1,284 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+
+#include "view.h"
+#include "adjacency.h"
+
+// immutable compressed sparse row snapshot of a graph or digraph
+// vertices are renumbered 0..n-1 in the order of V() and every
+// neighbor list is stored sorted in one contiguous array
+template <class Vertex>
+class csr {
+public:
+	typedef std::uint32_t Id;
+
+	// id used for "no vertex"
+	static constexpr Id none = std::numeric_limits<Id>::max();
+
+	// contiguous range of neighbor ids
+	struct Range {
+		const Id *first, *last;
+
+		const Id* begin() const { return first; }
+		const Id* end() const { return last; }
+		std::size_t size() const { return last - first; }
+	};
+	typedef const Id* const_iterator;
+
+	// empty snapshot
+	csr() : _directed(false), _loops(0), _off(1, 0) {
+		attach();
+	}
+
+	// snapshot of a graph, every edge is stored in both directions
+	template <class Adjacency>
+	explicit csr(const graph<Vertex, Adjacency> &G) : _directed(false), _loops(0) {
+		build(G);
+	}
+
+	// snapshot of a digraph, only out edges are stored
+	template <class Adjacency>
+	explicit csr(const digraph<Vertex, Adjacency> &D) : _directed(true), _loops(0) {
+		build(D);
+	}
+
+	// snapshot taking over prebuilt arrays, every neighbor list must be
+	// sorted and an undirected snapshot must store each edge both ways
+	csr(std::vector<Vertex> labels, std::vector<std::size_t> off, std::vector<Id> adj, bool directed)
+		: _directed(directed), _loops(0), _off(std::move(off)), _adj(std::move(adj)), _label(std::move(labels)) {
+		assert(_off.size() == _label.size() + 1 && _off.back() == _adj.size());
+		for (Id v = 0; v < n(); v++) {
+			for (std::size_t a = _off[v]; a < _off[v+1]; a++) {
+				_loops += (_adj[a] == v);
+			}
+		}
+		index();
+		attach();
+	}
+
+	// snapshot over arrays owned elsewhere (e.g. a mapped file), which are
+	// used in place and kept alive by keep
+	csr(std::vector<Vertex> labels, const std::size_t *off, const Id *adj, bool directed,
+		std::size_t loops, std::shared_ptr<const void> keep)
+		: _directed(directed), _loops(loops), _label(std::move(labels)), _keep(std::move(keep)) {
+		_offp = off;
+		_adjp = adj;
+		_arcs = off[n()];
+		index();
+	}
+
+	csr(const csr &o)
+		: _directed(o._directed), _loops(o._loops), _off(o._off), _adj(o._adj),
+		  _label(o._label), _id(o._id), _keep(o._keep) {
+		share(o);
+	}
+
+	csr& operator = (const csr &o) {
+		_directed = o._directed;
+		_loops = o._loops;
+		_off = o._off;
+		_adj = o._adj;
+		_label = o._label;
+		_id = o._id;
+		_keep = o._keep;
+		share(o);
+		return *this;
+	}
+
+	// moves keep the buffers of the owned vectors, so nothing is copied
+	csr(csr &&o) noexcept
+		: _directed(o._directed), _loops(o._loops), _off(std::move(o._off)), _adj(std::move(o._adj)),
+		  _label(std::move(o._label)), _id(std::move(o._id)), _keep(std::move(o._keep)) {
+		take(o);
+		o.vacate();
+	}
+
+	csr& operator = (csr &&o) noexcept {
+		if (this != &o) {
+			_directed = o._directed;
+			_loops = o._loops;
+			_off = std::move(o._off);
+			_adj = std::move(o._adj);
+			_label = std::move(o._label);
+			_id = std::move(o._id);
+			_keep = std::move(o._keep);
+			take(o);
+			o.vacate();
+		}
+		return *this;
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		return _label.size();
+	}
+
+	// number of edges
+	std::size_t m() const {
+		return _directed ? _arcs : (_arcs + _loops)/2;
+	}
+
+	// number of stored neighbor entries
+	std::size_t arcs() const {
+		return _arcs;
+	}
+
+	// number of self loops, stored once each
+	std::size_t loops() const {
+		return _loops;
+	}
+
+	// true if snapshot of a digraph
+	bool directed() const {
+		return _directed;
+	}
+
+	// return true if vertex is in snapshot
+	bool isVertex(const Vertex &v) const {
+		return (_id.count(v) != 0);
+	}
+
+	// return true if edge is in snapshot
+	bool isEdge(Id v, Id w) const {
+		assert(v < n() && w < n());
+		return std::binary_search(_adjp + _offp[v], _adjp + _offp[v+1], w);
+	}
+
+	// return dense id of vertex
+	Id id(const Vertex &v) const {
+		assert(isVertex(v));
+		return _id.at(v);
+	}
+
+	// return vertex with dense id
+	const Vertex& vertex(Id i) const {
+		assert(i < n());
+		return _label[i];
+	}
+
+	// return range of adjacent vertex ids
+	Range Adj(Id v) const {
+		assert(v < n());
+		return Range{_adjp + _offp[v], _adjp + _offp[v+1]};
+	}
+
+	// return degree / out degree of vertex id
+	std::size_t deg(Id v) const {
+		assert(v < n());
+		return _offp[v+1] - _offp[v];
+	}
+
+	// offsets into targets(), size n()+1
+	array_view<std::size_t> offsets() const {
+		return array_view<std::size_t>(_offp, n()+1);
+	}
+
+	// concatenated neighbor lists
+	array_view<Id> targets() const {
+		return array_view<Id>(_adjp, _arcs);
+	}
+
+	// vertex labels indexed by id
+	const std::vector<Vertex>& labels() const {
+		return _label;
+	}
+
+private:
+	bool _directed;
+	std::size_t _loops;						// self loops are stored once
+	std::vector<std::size_t> _off;			// owned storage, empty when borrowed
+	std::vector<Id> _adj;
+	const std::size_t *_offp;				// _adjp[_offp[v].._offp[v+1]) = Adj(v)
+	const Id *_adjp;
+	std::size_t _arcs;
+	std::vector<Vertex> _label;				// id -> vertex
+	std::unordered_map<Vertex, Id> _id;		// vertex -> id
+	std::shared_ptr<const void> _keep;		// owner of borrowed storage
+
+	// point at owned storage
+	void attach() {
+		_offp = _off.data();
+		_adjp = _adj.data();
+		_arcs = _adj.size();
+	}
+
+	// point at the storage a copy was made from
+	void share(const csr &o) {
+		if (o._keep) {
+			_offp = o._offp;
+			_adjp = o._adjp;
+			_arcs = o._arcs;
+		} else {
+			attach();
+		}
+	}
+
+	// point at the storage just moved from o, borrowed arrays stay where
+	// they are
+	void take(const csr &o) {
+		if (_keep) {
+			_offp = o._offp;
+			_adjp = o._adjp;
+			_arcs = o._arcs;
+		} else {
+			attach();
+		}
+	}
+
+	// leave a moved from snapshot empty, without allocating
+	void vacate() {
+		static const std::size_t zero = 0;
+		_loops = 0;
+		_off.clear();
+		_adj.clear();
+		_label.clear();
+		_id.clear();
+		_keep.reset();
+		_offp = &zero;
+		_adjp = nullptr;
+		_arcs = 0;
+	}
+
+	// fill vertex -> id from the labels
+	void index() {
+		assert(n() < none);
+		_id.reserve(n());
+		for (Id v = 0; v < n(); v++) {
+			_id[_label[v]] = v;
+		}
+	}
+
+	template <class G>
+	void build(const G &g) {
+		assert(g.n() < none);
+
+		_label.assign(g.V().begin(), g.V().end());
+		index();
+
+		_off.assign(n()+1, 0);
+		_adj.reserve(_directed ? g.m() : 2*g.m());
+		for (Id v = 0; v < n(); v++) {
+			for (auto &w : g.Adj(_label[v])) {
+				Id i = _id.at(w);
+				_adj.push_back(i);
+				if (i == v) {
+					_loops++;
+				}
+			}
+			std::sort(_adj.begin() + _off[v], _adj.end());
+			_off[v+1] = _adj.size();
+		}
+		attach();
+	}
+
+};
+
+#endif // CSR_H
@@ -2,66 +2,228 @@
 #define DFS_H
 
 #include <unordered_map>
+#include <memory_resource>
+#include <unordered_set>
+#include <vector>
+#include <utility>
+#include <limits>
+#include <cassert>
 
-template <class Vertex> class graph;
+#include "arena.h"
+#include "csr.h"
+#include "packed.h"
+#include "stats.h"
+#include "adjacency.h"
+
+// block-cut tree, nodes 0..blocks.size()-1 of tree are the blocks and the
+// following nodes are the cut vertices in the order of cuts
+template <class Vertex>
+struct BlockCutTree {
+	std::vector< std::vector<Vertex> > blocks;	// vertices of each block
+	std::vector<Vertex> cuts;					// articulation points
+	graph<std::size_t> tree;					// block i - cut j edges
+};
 
 template <class Vertex>
 class DFS {
+	template <class Set> struct Frame;
+	template <class It> struct DFrame;
+
 public:
-	DFS(const graph<Vertex> &G, const Vertex &start = Vertex()) {
+	typedef typename csr<Vertex>::Id Id;
+
+	template <class Adjacency>
+	DFS(const graph<Vertex, Adjacency> &G, const Vertex &start = Vertex()) {
+		STATS_PHASE("DFS");
 		_ncc = _time = 0;
+		std::vector< Frame<typename graph<Vertex, Adjacency>::VertexSet> > stack;
+		_B.reserve(G.n());
 
 		if (G.isVertex(start)) {
-			dfs_one(G, start);
+			dfs_one(G, start, stack);
 			_ncc++;
 		}
 
 		for (auto &v : G.V()) {
 			if (_pre.count(v) == 0) {
-				dfs_one(G, v);
+				dfs_one(G, v, stack);
 				_ncc++;
 			}
 		}
 	}
 
-	void dfs_one(const graph<Vertex> &G, const Vertex &v) {
-		_pre[v] = _low[v] = _time++;
-		_C[v] = _ncc;
-		for (auto &w : G.Adj(v)) {
-			if (_pre.count(w) == 0) {
-				_P[w] = v;
-				dfs_one(G, w);
-				_low[v] = std::min(_low[v], _low[w]);
-			} else if (_P.count(v) == 0 || _P[v] != w) {
-				_low[v] = std::min(_low[v], _pre[w]);
+	// iterative search, the explicit stack is reused between calls
+	// biconnected blocks, bridges and articulation points are found in the
+	// same pass: when child u finishes with low[u] >= pre[p], the vertices
+	// entered since u together with p form one block
+	template <class Adjacency, class Set>
+	void dfs_one(const graph<Vertex, Adjacency> &G, const Vertex &v, std::vector< Frame<Set> > &stack) {
+		std::size_t children(0);
+		enter(G, v, stack);
+
+		while (!stack.empty()) {
+			Frame<Set> &f = stack.back();
+			if (f.next != f.end) {
+				const Vertex &w = *(f.next++);
+				STATS_ADD(dfs_edges, 1);
+				if (_pre.count(w) == 0) {
+					children += (stack.size() == 1);
+					_P[w] = f.v;
+					enter(G, w, stack);
+					_bstack.push_back(w);
+				} else if (_P.count(f.v) == 0 || _P[f.v] != w) {
+					_low[f.v] = std::min(_low[f.v], _pre[w]);
+				}
+			} else {
+				Vertex u = f.v;
+				_post[u] = _time++;
+				stack.pop_back();
+				if (!stack.empty()) {
+					Vertex &p = stack.back().v;
+					_low[p] = std::min(_low[p], _low[u]);
+
+					if (_low[u] >= _pre[p]) {
+						if (_low[u] > _pre[p]) {
+							_bridges.push_back(std::make_pair(p, u));
+						}
+						if (stack.size() > 1) {
+							_cut.insert(p);
+						}
+
+						_blocks.push_back(std::vector<Vertex>(1, p));
+						Vertex x;
+						do {
+							x = _bstack.back();
+							_bstack.pop_back();
+							_B[x] = _blocks.size()-1;
+							_blocks.back().push_back(x);
+						} while (x != u);
+					}
+				}
 			}
 		}
-		_post[v] = _time++;
+
+		if (children >= 2) {
+			_cut.insert(v);
+		}
+	}
+
+	// same search on a csr snapshot, results are translated back to vertices
+	DFS(const csr<Vertex> &G, const Vertex &start = Vertex()) {
+		STATS_PHASE("DFS/csr");
+		search(G, start);
+	}
+
+	// same search decoding the neighbor lists of a packed snapshot
+	DFS(const packed_csr<Vertex> &G, const Vertex &start = Vertex()) {
+		STATS_PHASE("DFS/packed");
+		search(G, start);
+	}
+
+	// search every component of a snapshot, starting with start
+	template <class Snapshot>
+	void search(const Snapshot &G, const Vertex &start) {
+		_ncc = _time = 0;
+		std::vector< DFrame<typename Snapshot::const_iterator> > stack;
+		_dpre.assign(G.n(), inf);
+		_dpost.assign(G.n(), 0);
+		_dlow.assign(G.n(), 0);
+		_dC.assign(G.n(), 0);
+		_dP.assign(G.n(), csr<Vertex>::none);
+		_dB.assign(G.n(), inf);
+
+		if (G.isVertex(start)) {
+			dfs_one(G, G.id(start), stack);
+			_ncc++;
+		}
+
+		for (Id v = 0; v < G.n(); v++) {
+			if (_dpre[v] == inf) {
+				dfs_one(G, v, stack);
+				_ncc++;
+			}
+		}
+
+		translate(G);
+	}
+
+	// iterative search, the explicit stack is reused between calls
+	template <class Snapshot, class It>
+	void dfs_one(const Snapshot &G, Id v, std::vector< DFrame<It> > &stack) {
+		std::size_t children(0);
+		enter(G, v, stack);
+
+		while (!stack.empty()) {
+			DFrame<It> &f = stack.back();
+			if (f.next != f.end) {
+				Id w = *f.next;
+				++f.next;
+				STATS_ADD(dfs_edges, 1);
+				if (_dpre[w] == inf) {
+					children += (stack.size() == 1);
+					_dP[w] = f.v;
+					enter(G, w, stack);
+					_dbstack.push_back(w);
+				} else if (_dP[f.v] != w) {
+					_dlow[f.v] = std::min(_dlow[f.v], _dpre[w]);
+				}
+			} else {
+				Id u = f.v;
+				_dpost[u] = _time++;
+				stack.pop_back();
+				if (!stack.empty()) {
+					Id p = stack.back().v;
+					_dlow[p] = std::min(_dlow[p], _dlow[u]);
+
+					if (_dlow[u] >= _dpre[p]) {
+						if (_dlow[u] > _dpre[p]) {
+							_bridges.push_back(std::make_pair(G.vertex(p), G.vertex(u)));
+						}
+						if (stack.size() > 1) {
+							_cut.insert(G.vertex(p));
+						}
+
+						_blocks.push_back(std::vector<Vertex>(1, G.vertex(p)));
+						Id x;
+						do {
+							x = _dbstack.back();
+							_dbstack.pop_back();
+							_dB[x] = _blocks.size()-1;
+							_blocks.back().push_back(G.vertex(x));
+						} while (x != u);
+					}
+				}
+			}
+		}
+
+		if (children >= 2) {
+			_cut.insert(G.vertex(v));
+		}
 	}
 
 	// pre times for each vertex
 	std::unordered_map<Vertex, std::size_t> pre() const {
-		return _pre;
+		return std::unordered_map<Vertex, std::size_t>(_pre.begin(), _pre.end());
 	}
 
 	// post times for each vertex
 	std::unordered_map<Vertex, std::size_t> post() const {
-		return _post;
+		return std::unordered_map<Vertex, std::size_t>(_post.begin(), _post.end());
 	}
 
 	// low times for each vertex
 	std::unordered_map<Vertex, std::size_t> low() const {
-		return _low;
+		return std::unordered_map<Vertex, std::size_t>(_low.begin(), _low.end());
 	}
 
 	// parents of each vertex in Depth First Tree
 	std::unordered_map<Vertex, Vertex> dfTree() const {
-		return _P;
+		return std::unordered_map<Vertex, Vertex>(_P.begin(), _P.end());
 	}
 
 	// component ids for each vertex
 	std::unordered_map<Vertex, std::size_t> components() const {
-		return _C;
+		return std::unordered_map<Vertex, std::size_t>(_C.begin(), _C.end());
 	}
 
 	// number of connected components
@@ -76,29 +238,145 @@ public:
 	}
 
 	// return true if vertex v is an articulation point
-	bool isArticulation(const Vertex &v) {
-		if (_P.count(v) == 0) {				// root has more than one child
-			int nchildren(0);
-			for (auto &p : _P) {
-				if (p.second == v) {
-					nchildren++;
-				}
-			}
-			return (nchildren >= 2);
-		} else {							// pre time smaller than low of children 
-			for (auto &p : _P) {
-				if (p.second == v && _low[p.first] >= _pre[v]) {
-					return true;
+	bool isArticulation(const Vertex &v) const {
+		return (_cut.count(v) != 0);
+	}
+
+	// all bridges as (parent, child) pairs of the Depth First Tree
+	std::vector< std::pair<Vertex, Vertex> > bridges() const {
+		return _bridges;
+	}
+
+	// all articulation points
+	std::unordered_set<Vertex> articulations() const {
+		return std::unordered_set<Vertex>(_cut.begin(), _cut.end());
+	}
+
+	// number of biconnected blocks, isolated vertices have none
+	std::size_t nbcc() const {
+		return _blocks.size();
+	}
+
+	// block id of edge between v and w, which is the block of the tree edge
+	// above whichever end was entered last
+	std::size_t bcc(const Vertex &v, const Vertex &w) const {
+		assert(v != w);
+		return _B.at((_pre.at(v) > _pre.at(w)) ? v : w);
+	}
+
+	// vertices of each biconnected block
+	std::vector< std::vector<Vertex> > blocks() const {
+		return _blocks;
+	}
+
+	// block-cut tree (a forest if the graph is not connected)
+	BlockCutTree<Vertex> blockCutTree() const {
+		BlockCutTree<Vertex> ans;
+		ans.blocks = _blocks;
+		ans.cuts.assign(_cut.begin(), _cut.end());
+
+		std::unordered_map<Vertex, std::size_t> node;
+		for (std::size_t i = 0; i < ans.cuts.size(); i++) {
+			node[ans.cuts[i]] = _blocks.size() + i;
+		}
+
+		for (std::size_t i = 0; i < _blocks.size() + ans.cuts.size(); i++) {
+			ans.tree.addVertex(i);
+		}
+		for (std::size_t b = 0; b < _blocks.size(); b++) {
+			for (auto &v : _blocks[b]) {
+				if (node.count(v) != 0) {
+					ans.tree.addEdge(b, node.at(v));
 				}
 			}
-			return false;
 		}
+		return ans;
 	}
 
 private:
+	static constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+
 	std::size_t _ncc, _time;
-	std::unordered_map<Vertex, std::size_t> _pre, _post, _low, _C;
-	std::unordered_map<Vertex, Vertex> _P;
+
+	// vertex maps of a run come from one arena, freed together with it
+	arena_ptr _arena;
+	std::pmr::unordered_map<Vertex, std::size_t> _pre{_arena.get()}, _post{_arena.get()}, _low{_arena.get()}, _C{_arena.get()};
+	std::pmr::unordered_map<Vertex, Vertex> _P{_arena.get()};
+
+	// biconnectivity, _B[v] is the block of the tree edge from _P[v] to v
+	std::pmr::unordered_map<Vertex, std::size_t> _B{_arena.get()};
+	std::pmr::unordered_set<Vertex> _cut{_arena.get()};
+	std::vector< std::pair<Vertex, Vertex> > _bridges;
+	std::vector< std::vector<Vertex> > _blocks;
+	std::vector<Vertex> _bstack;				// entered vertices not yet in a block
+
+	// explicit stack frame, a vertex and its next unexplored neighbor
+	template <class Set>
+	struct Frame {
+		Vertex v;
+		typename Set::const_iterator next, end;
+	};
+
+	// dense state of a csr search, indexed by id
+	std::vector<std::size_t> _dpre, _dpost, _dlow, _dC, _dB;
+	std::vector<Id> _dP, _dbstack;
+
+	// snapshot stack frame, a vertex id and its next unexplored neighbor
+	template <class It>
+	struct DFrame {
+		Id v;
+		It next, end;
+	};
+
+	// number v and push it on the stack
+	template <class Adjacency, class Set>
+	void enter(const graph<Vertex, Adjacency> &G, const Vertex &v, std::vector< Frame<Set> > &stack) {
+		_pre[v] = _low[v] = _time++;
+		_C[v] = _ncc;
+		STATS_ADD(dfs_vertices, 1);
+		const Set &adj = G.Adj(v);
+		stack.push_back(Frame<Set>{v, adj.begin(), adj.end()});
+	}
+
+	template <class Snapshot, class It>
+	void enter(const Snapshot &G, Id v, std::vector< DFrame<It> > &stack) {
+		_dpre[v] = _dlow[v] = _time++;
+		_dC[v] = _ncc;
+		STATS_ADD(dfs_vertices, 1);
+		typename Snapshot::Range adj = G.Adj(v);
+		stack.push_back(DFrame<It>{v, adj.begin(), adj.end()});
+	}
+
+	// copy dense state into the vertex maps and release it
+	template <class Snapshot>
+	void translate(const Snapshot &G) {
+		_pre.reserve(G.n());
+		_post.reserve(G.n());
+		_low.reserve(G.n());
+		_C.reserve(G.n());
+		_P.reserve(G.n());
+		_B.reserve(G.n());
+		for (Id v = 0; v < G.n(); v++) {
+			_pre[G.vertex(v)] = _dpre[v];
+			_post[G.vertex(v)] = _dpost[v];
+			_low[G.vertex(v)] = _dlow[v];
+			_C[G.vertex(v)] = _dC[v];
+			if (_dP[v] != csr<Vertex>::none) {
+				_P[G.vertex(v)] = G.vertex(_dP[v]);
+			}
+			if (_dB[v] != inf) {
+				_B[G.vertex(v)] = _dB[v];
+			}
+		}
+
+		std::vector<std::size_t>().swap(_dpre);
+		std::vector<std::size_t>().swap(_dpost);
+		std::vector<std::size_t>().swap(_dlow);
+		std::vector<std::size_t>().swap(_dC);
+		std::vector<std::size_t>().swap(_dB);
+		std::vector<Id>().swap(_dP);
+		std::vector<Id>().swap(_dbstack);
+	}
 
 };
 
@@ -0,0 +1,207 @@
+#ifndef EDGE_FILE_H
+#define EDGE_FILE_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "binary.h"
+#include "stats.h"
+
+// binary graph file whose neighbor lists stay on disk: only the header and
+// the offsets (8 bytes per vertex) are read into memory, and every scan
+// streams the targets in order through one buffer of large blocks
+//
+//   edge_file E;
+//   E.open("road.bin");
+//   E.scan([&](Id v, const Id *first, const Id *last) { ... });
+//
+// for semi external algorithms, whose per vertex state fits in memory but
+// whose edges do not
+class edge_file {
+public:
+	typedef std::uint32_t Id;
+
+	// arcs read per block, 64MiB of targets
+	static constexpr std::size_t default_block = std::size_t(1) << 24;
+
+	edge_file() : _fd(-1) { }
+
+	edge_file(const edge_file&) = delete;
+	edge_file& operator = (const edge_file&) = delete;
+
+	~edge_file() {
+		close();
+	}
+
+	// return true if path holds a valid file whose sections fit in it and
+	// whose offsets never decrease, block is the number of arcs read at a
+	// time; targets are checked as they are scanned
+	bool open(const std::string &path, std::size_t block = default_block) {
+		close();
+		_fd = ::open(path.c_str(), O_RDONLY);
+		if (_fd < 0) {
+			return false;
+		}
+
+		struct stat st;
+		if (::fstat(_fd, &st) != 0 || !read_at(&_h, sizeof(_h), 0)
+			|| !_L.locate(_h, std::size_t(st.st_size))) {
+			close();
+			return false;
+		}
+
+		_off.resize(_h.n + 1);
+		if (!read_at(_off.data(), _off.size()*sizeof(std::uint64_t), _L.off)
+			|| !binary_offsets(_off.data(), _h.n, _h.arcs)) {
+			close();
+			return false;
+		}
+		_block = std::max<std::size_t>(block, 1);
+#ifdef POSIX_FADV_SEQUENTIAL
+		posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+		return true;
+	}
+
+	void close() {
+		if (_fd >= 0) {
+			::close(_fd);
+		}
+		_fd = -1;
+		std::vector<std::size_t>().swap(_off);
+		std::vector<Id>().swap(_buf);
+	}
+
+	// true if a file is open
+	bool isOpen() const {
+		return _fd >= 0;
+	}
+
+	graph_kind kind() const {
+		assert(isOpen());
+		return graph_kind(_h.kind);
+	}
+
+	// true if the file holds a digraph, network or flownetwork
+	bool directed() const {
+		return !isUndirected(kind());
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		assert(isOpen());
+		return _h.n;
+	}
+
+	// number of stored neighbor entries
+	std::size_t arcs() const {
+		assert(isOpen());
+		return _h.arcs;
+	}
+
+	// return degree / out degree of vertex id
+	std::size_t deg(Id v) const {
+		assert(v < n());
+		return _off[v+1] - _off[v];
+	}
+
+	// call f(v, first, last) with the neighbors of every vertex v in id
+	// order; a list longer than a block comes in several consecutive pieces
+	template <class F>
+	bool scan(F f) {
+		return scan([](Id) { return true; }, f);
+	}
+
+	// same for the vertices v with want(v), in one forward pass whose reads
+	// start at a wanted list and stop after the last one fitting in a block,
+	// returns false on a read error or a target that is not a vertex
+	template <class Want, class F>
+	bool scan(Want want, F f) {
+		assert(isOpen());
+		STATS_ADD(io_passes, 1);
+		_buf.resize(std::min(_block, arcs()));
+		std::size_t lo(0), hi(0);				// arcs [lo, hi) are in _buf
+
+		for (Id v = 0; v < n(); v++) {
+			if (_off[v] == _off[v+1] || !want(v)) {
+				continue;
+			}
+			for (std::size_t a = _off[v]; a < _off[v+1]; ) {
+				if (a < lo || a >= hi) {
+					// read up to the end of the last wanted list within a block
+					lo = a;
+					hi = std::min<std::size_t>(a + _buf.size(), _off[v+1]);
+					for (Id u = v + 1; u < n() && _off[u+1] <= lo + _buf.size(); u++) {
+						if (_off[u] != _off[u+1] && want(u)) {
+							hi = _off[u+1];
+						}
+					}
+					if (!read_at(_buf.data(), (hi - lo)*sizeof(Id), _L.adj + lo*sizeof(Id))
+						|| !binary_targets(_buf.data(), _buf.data() + (hi - lo), n())) {
+						return false;
+					}
+					STATS_ADD(io_bytes, (hi - lo)*sizeof(Id));
+				}
+				std::size_t e = std::min<std::size_t>(_off[v+1], hi);
+				f(v, _buf.data() + (a - lo), _buf.data() + (e - lo));
+				a = e;
+			}
+		}
+		return true;
+	}
+
+	// labels of every vertex parsed as Vertex, read from the end of the
+	// file; false on a read error or label offsets out of order
+	template <class Vertex>
+	bool labels(std::vector<Vertex> &ans) const {
+		assert(isOpen());
+		std::vector<std::uint64_t> loff(n() + 1);
+		std::string bytes(_h.label_bytes, '\0');
+		if (!read_at(loff.data(), loff.size()*sizeof(std::uint64_t), _L.loff)
+			|| !read_at(&bytes[0], bytes.size(), _L.lbytes)
+			|| !binary_offsets(loff.data(), n(), bytes.size())) {
+			return false;
+		}
+
+		ans.clear();
+		ans.reserve(n());
+		for (Id v = 0; v < n(); v++) {
+			ans.push_back(parse_label<Vertex>(std::string_view(bytes.data() + loff[v], loff[v+1] - loff[v])));
+		}
+		return true;
+	}
+
+private:
+	int _fd;
+	binary_header _h;
+	std::vector<std::size_t> _off;		// offsets of the neighbor lists, in memory
+	binary_layout _L;					// file positions of the sections
+	std::size_t _block;					// arcs per read
+	std::vector<Id> _buf;				// block being scanned
+
+	// read exactly bytes at file position pos
+	bool read_at(void *p, std::size_t bytes, std::size_t pos) const {
+		char *c = static_cast<char*>(p);
+		while (bytes > 0) {
+			ssize_t k = ::pread(_fd, c, bytes, pos);
+			if (k <= 0) {
+				return false;
+			}
+			c += k;
+			bytes -= k;
+			pos += k;
+		}
+		return true;
+	}
+
+};
+
+#endif // EDGE_FILE_H
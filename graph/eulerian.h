@@ -3,14 +3,24 @@
 
 #include <vector>
 
-template <class Vertex> class graph;
+#include "csr.h"
+#include "bitmap.h"
+#include "stats.h"
+#include "adjacency.h"
 
 template <class Vertex>
 class Eulerian {
 public:
 	// A graph is Eulerian if no vertices have odd degree
 	// A graph is Semi-Eulerian if only two vertices have odd degree
-	Eulerian(graph<Vertex> G) {
+	// G is only read; a trail is found on a csr snapshot of it, built in
+	// O(n + m) and only if the degrees allow one: hash sets give no arc
+	// ids to mark used or to pair with their reverse, and the snapshot's
+	// targets with the pairing of reverse arcs (about 12 bytes per arc) are
+	// smaller than the hash set nodes of a copy
+	template <class Adjacency>
+	Eulerian(const graph<Vertex, Adjacency> &G) {
+		STATS_PHASE("Eulerian");
 		_hasCycle = _hasPath = false;
 		Vertex start;
 
@@ -38,8 +48,42 @@ public:
 				return;
 		}
 
-		_path = findPath(G, start);
+		csr<Vertex> S(G);
+		findPath(S, S.id(start));
+	}
+
+	// same test on a csr snapshot, trail is found with Hierholzer's algorithm
+	Eulerian(const csr<Vertex> &G) {
+		STATS_PHASE("Eulerian/csr");
+		typedef typename csr<Vertex>::Id Id;
+		_hasCycle = _hasPath = false;
+		Id start(0);
+
+		if (G.n() == 0) {
+			return;
+		}
+
+		std::size_t oddCount(0);
+		for (Id v = 0; v < G.n(); v++) {
+			if (G.deg(v) % 2 == 1) {
+				oddCount++;
+				start = v;
+			}
+		}
+
+		switch(oddCount) {
+			case 0:			// Eulerian
+				_hasCycle = _hasPath = true;
+				start = 0;
+				break;
+			case 2:			// Semi-Eulerian
+				_hasPath = true;
+				break;
+			default:		// Neither
+				return;
+		}
 
+		findPath(G, start);
 	}
 
 	// true if Eulerian
@@ -61,17 +105,44 @@ private:
 	bool _hasCycle, _hasPath;
 	std::vector<Vertex> _path;
 
-	// start from vertex v and follow any edges
-	std::vector<Vertex> findPath(graph<Vertex> &G, const Vertex &v) {
-		std::vector<Vertex> ans;
-		while (G.deg(v) > 0) {
-			Vertex w = *(G.Adj(v).begin());
-			G.removeEdge(v, w);
-			std::vector<Vertex> p = findPath(G, w);
-			ans.insert(ans.end(), p.begin(), p.end());
+	// iterative Hierholzer from vertex id v, each edge is used once
+	void findPath(const csr<Vertex> &G, typename csr<Vertex>::Id v) {
+		typedef typename csr<Vertex>::Id Id;
+		array_view<std::size_t> off = G.offsets();
+		array_view<Id> adj = G.targets();
+
+		// mate[a] is the position of the reverse of arc a, found in one
+		// pass because every neighbor list is sorted
+		std::vector<std::size_t> mate(adj.size()), cursor(off.begin(), off.end()-1);
+		for (Id u = 0; u < G.n(); u++) {
+			for (std::size_t a = off[u]; a < off[u+1]; a++) {
+				mate[a] = cursor[adj[a]]++;
+			}
+		}
+
+		bitmap used(adj.size());
+		std::vector<std::size_t> next(off.begin(), off.end()-1);
+		std::vector<Id> S;
+		S.reserve(G.m() + 1);
+		S.push_back(v);
+		_path.reserve(G.m() + 1);
+
+		while (!S.empty()) {
+			Id u = S.back();
+			while (next[u] < off[u+1] && used.test(next[u])) {
+				next[u]++;
+			}
+
+			if (next[u] == off[u+1]) {
+				_path.push_back(G.vertex(u));
+				S.pop_back();
+			} else {
+				std::size_t a = next[u]++;
+				used.set(a);
+				used.set(mate[a]);
+				S.push_back(adj[a]);
+			}
 		}
-		ans.push_back(v);
-		return ans;
 	}
 
 };
@@ -2,22 +2,35 @@
 #define GRAPH_H
 
 #include <unordered_map>
-#include <unordered_set>
+#include <memory_resource>
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <vector>
+#include <thread>
+
+#include "view.h"
+#include "adjacency.h"
 
 template <class Vertex> class BFS;
 template <class Vertex> class DFS;
 template <class Vertex> class Eulerian;
+template <class Vertex> class csr;
+template <class Vertex> class PCC;
 
-template <class Vertex>
+// Adjacency picks the neighbor set of each vertex (adjacency.h)
+template <class Vertex, class Adjacency>
 class graph {
 public:
-	typedef std::unordered_set<Vertex> VertexSet;
+	typedef typename Adjacency::template set<Vertex> VertexSet;
+	typedef key_view< std::pmr::unordered_map<Vertex, VertexSet> > VertexRange;
 
 	// default constructor
-	graph() { }
+	graph() : _m(0) { }
+
+	// adjacency allocated from r (e.g. an arena), which must outlive the
+	// graph; copies allocate from the default resource
+	explicit graph(std::pmr::memory_resource *r) : _t(r), _m(0) { }
 
 	// number of vertices
 	std::size_t n() const {
@@ -26,20 +39,12 @@ public:
 
 	// number of edges
 	std::size_t m() const {
-		std::size_t ans(0);
-		for (auto &p : _t) {
-			ans += p.second.size();
-		}
-		return ans/2;
+		return _m;
 	}
 
-	// return set of all vertices
-	VertexSet V() const {
-		VertexSet ans;
-		for (auto &p : _t) {
-			ans.insert(p.first);
-		}
-		return ans;
+	// return view of all vertices
+	VertexRange V() const {
+		return VertexRange(_t);
 	}
 
 	// return true if vertex is in graph
@@ -52,8 +57,8 @@ public:
 		return isVertex(v) && isVertex(w) && (_t.at(v).count(w) != 0);
 	}
 
-	// return set of adjacent vertices
-	VertexSet Adj(const Vertex &v) const {
+	// return set of adjacent vertices without copying
+	const VertexSet& Adj(const Vertex &v) const {
 		assert(isVertex(v));
 		return _t.at(v);
 	}
@@ -68,7 +73,7 @@ public:
 	bool addVertex(const Vertex &v) {
 		if (isVertex(v)) { return false; }
 
-		_t[v] = VertexSet();
+		_t.try_emplace(v);
 		return true;
 	}
 
@@ -79,6 +84,7 @@ public:
 
 		_t[v].insert(w);
 		_t[w].insert(v);
+		_m++;
 		return true;
 	}
 
@@ -86,11 +92,14 @@ public:
 	void removeVertex(const Vertex &v) {
 		assert(isVertex(v));
 
-		for (auto &p : _t) {
-			p.second.remove(v);
+		_m -= _t[v].size();
+		for (auto &w : _t[v]) {
+			if (w != v) {
+				_t[w].erase(v);
+			}
 		}
 
-		_t.remove(v);
+		_t.erase(v);
 	}
 
 	// removes edge if in graph
@@ -98,10 +107,17 @@ public:
 		assert(isVertex(v) && isVertex(w) && isEdge(v, w));
 		_t[v].erase(w);
 		_t[w].erase(v);
+		_m--;
 	}
 
 	// number of connected components
 	std::size_t ncc() const {
+		// large graphs are snapshotted and counted on all cores
+		if (n() >= parallel_n && std::thread::hardware_concurrency() > 1) {
+			PCC<Vertex> p{csr<Vertex>(*this)};
+			return p.ncc();
+		}
+
 		BFS<Vertex> b(*this);
 		return b.ncc();
 
@@ -125,18 +141,22 @@ public:
 	}
 
 private:
+	// vertex count from which ncc() runs in parallel
+	static constexpr std::size_t parallel_n = 1 << 16;
+
 	// adjacency "hashmap" representation
-	std::unordered_map<Vertex, VertexSet> _t;
+	std::pmr::unordered_map<Vertex, VertexSet> _t;
+	std::size_t _m;							// number of edges
 
 };
 
 // input graph
-template <class Vertex>
-std::istream& operator >> (std::istream &is, graph<Vertex> &G) {
+template <class Vertex, class Adjacency>
+std::istream& operator >> (std::istream &is, graph<Vertex, Adjacency> &G) {
 	std::size_t n, m;
 	Vertex v, w;
 
-	G = graph<Vertex>();
+	G = graph<Vertex, Adjacency>();
 
 	is >> n >> m;
 	for (std::size_t i = 0; i < n; i++) {
@@ -153,8 +173,8 @@ std::istream& operator >> (std::istream &is, graph<Vertex> &G) {
 }
 
 // output graph
-template <class Vertex>
-std::ostream& operator << (std::ostream &os, graph<Vertex> &G) {
+template <class Vertex, class Adjacency>
+std::ostream& operator << (std::ostream &os, graph<Vertex, Adjacency> &G) {
 	os << "\nGraph:" << std::endl;
 	os << "# Vertices: " << G.n() << "\n# Edges: " << G.m() << std::endl << std::endl;
 
@@ -2,15 +2,17 @@
 #include <fstream>
 #include <cassert>
 
+#include "symbol.h"
 #include "graph.h"
 #include "bfs.h"
 #include "dfs.h"
 #include "eulerian.h"
+#include "pcc.h"
 
 using namespace std;
 
 int main() {
-	graph<string> G;
+	graph<symbol> G;
 	cin >> G;
 	cout << G;
 }
\ No newline at end of file
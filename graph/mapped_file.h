@@ -0,0 +1,93 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// read only contents of a file, mapped into memory when the file is
+// regular and read into a buffer otherwise (e.g. a pipe on /dev/stdin)
+class mapped_file {
+public:
+	mapped_file(const mapped_file &) = delete;
+	mapped_file& operator = (const mapped_file &) = delete;
+
+	~mapped_file() {
+		if (_mapped) {
+			munmap(const_cast<char*>(_data), _size);
+		}
+	}
+
+	// contents of path, null if it cannot be read
+	static std::shared_ptr<mapped_file> open(const std::string &path) {
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return nullptr;
+		}
+
+		std::shared_ptr<mapped_file> ans(new mapped_file());
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			::close(fd);
+			return nullptr;
+		}
+
+		if (S_ISREG(st.st_mode) && st.st_size > 0) {
+			void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (p != MAP_FAILED) {
+				madvise(p, st.st_size, MADV_SEQUENTIAL);
+				ans->_data = static_cast<const char*>(p);
+				ans->_size = st.st_size;
+				ans->_mapped = true;
+				::close(fd);
+				return ans;
+			}
+		}
+
+		char buf[1 << 16];
+		for (ssize_t k; (k = ::read(fd, buf, sizeof(buf))) != 0; ) {
+			if (k < 0) {
+				::close(fd);
+				return nullptr;
+			}
+			ans->_buf.insert(ans->_buf.end(), buf, buf + k);
+		}
+		::close(fd);
+		ans->_data = ans->_buf.data();
+		ans->_size = ans->_buf.size();
+		return ans;
+	}
+
+	const char* data() const {
+		return _data;
+	}
+
+	std::size_t size() const {
+		return _size;
+	}
+
+	const char* begin() const {
+		return _data;
+	}
+
+	const char* end() const {
+		return _data + _size;
+	}
+
+private:
+	const char *_data;
+	std::size_t _size;
+	bool _mapped;
+	std::vector<char> _buf;
+
+	mapped_file() : _data(nullptr), _size(0), _mapped(false) { }
+
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,134 @@
+#ifndef MSBFS_H
+#define MSBFS_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+#include "csr.h"
+
+// bit parallel multi source Breadth First Search (Then et al.)
+// sources are searched in batches of 64*Words, every vertex keeps one bit
+// per source of the batch so each edge is scanned once per batch and level;
+// Words = 4 gives 256 wide batches that compile to SIMD word operations
+template <class Vertex, std::size_t Words = 1>
+class MSBFS {
+public:
+	typedef typename csr<Vertex>::Id Id;
+	typedef std::uint32_t Distance;
+	typedef std::uint64_t word;
+
+	// distance to vertices not reachable from a source
+	static constexpr Distance inf = std::numeric_limits<Distance>::max();
+
+	// sources per batch
+	static constexpr std::size_t width = 64*Words;
+
+	MSBFS(const csr<Vertex> &G, const std::vector<Vertex> &sources) : _n(G.n()), _ns(sources.size()) {
+		_D.assign(_ns*_n, inf);
+		_seen.resize(_n*Words);
+		_visit.resize(_n*Words);
+		_next.resize(_n*Words);
+
+		for (std::size_t b = 0; b < _ns; b += width) {
+			batch(G, sources, b, std::min(_ns, b + width));
+		}
+
+		std::vector<word>().swap(_seen);
+		std::vector<word>().swap(_visit);
+		std::vector<word>().swap(_next);
+	}
+
+	// number of sources
+	std::size_t sources() const {
+		return _ns;
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		return _n;
+	}
+
+	// distance from source i to vertex id v
+	Distance distance(std::size_t i, Id v) const {
+		assert(i < _ns && v < _n);
+		return _D[i*_n + v];
+	}
+
+	// sources x vertices distances, row i holds source i indexed by vertex id
+	const std::vector<Distance>& matrix() const {
+		return _D;
+	}
+
+private:
+	std::size_t _n, _ns;
+	std::vector<Distance> _D;
+	std::vector<word> _seen, _visit, _next;		// Words per vertex
+
+	// search sources [lo, hi) together
+	void batch(const csr<Vertex> &G, const std::vector<Vertex> &sources, std::size_t lo, std::size_t hi) {
+		std::fill(_seen.begin(), _seen.end(), 0);
+		std::fill(_visit.begin(), _visit.end(), 0);
+		std::fill(_next.begin(), _next.end(), 0);
+
+		for (std::size_t i = lo; i < hi; i++) {
+			Id s = G.id(sources[i]);
+			std::size_t k = i - lo;
+			_seen[s*Words + k/64] |= word(1) << (k%64);
+			_visit[s*Words + k/64] |= word(1) << (k%64);
+			_D[i*_n + s] = 0;
+		}
+
+		bool active(true);
+		for (Distance level = 1; active; level++) {
+			// push every frontier bit along the out edges
+			for (Id v = 0; v < _n; v++) {
+				const word *x = &_visit[v*Words];
+				if (empty(x)) {
+					continue;
+				}
+				for (Id w : G.Adj(v)) {
+					word *y = &_next[w*Words];
+					for (std::size_t j = 0; j < Words; j++) {
+						y[j] |= x[j];
+					}
+				}
+			}
+
+			// keep only sources reaching a vertex for the first time
+			active = false;
+			for (Id w = 0; w < _n; w++) {
+				word *y = &_next[w*Words];
+				word *s = &_seen[w*Words];
+				word *x = &_visit[w*Words];
+				for (std::size_t j = 0; j < Words; j++) {
+					word fresh = y[j] & ~s[j];
+					s[j] |= fresh;
+					x[j] = fresh;
+					y[j] = 0;
+
+					while (fresh != 0) {
+						std::size_t k = 64*j + __builtin_ctzll(fresh);
+						_D[(lo + k)*_n + w] = level;
+						fresh &= fresh - 1;
+						active = true;
+					}
+				}
+			}
+		}
+	}
+
+	// true if no bit of a vertex lane is set
+	static bool empty(const word *x) {
+		word any(0);
+		for (std::size_t j = 0; j < Words; j++) {
+			any |= x[j];
+		}
+		return any == 0;
+	}
+
+};
+
+#endif // MSBFS_H
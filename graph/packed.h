@@ -0,0 +1,355 @@
+#ifndef PACKED_H
+#define PACKED_H
+
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+#include "csr.h"
+#include "adjacency.h"
+
+// immutable compressed snapshot of a graph or digraph, the same vertex
+// numbering and sorted neighbor lists as csr but each list is stored as
+// its degree (a varint) followed by gaps between consecutive neighbors,
+// the first one taken from the vertex itself. gaps are packed four at a
+// time behind a control byte holding their byte lengths (group varint,
+// the layout of StreamVByte with control and data interleaved so every
+// list is self contained), and decoded on the fly while iterating
+//
+//   csr<int> S(G);
+//   packed_csr<int> P(reorder(S, bfs_order(S)));	// small gaps pack best
+//   BFS<int> b(P, 0);
+//
+// neighbor lists are read only through forward iterators, there is no
+// random access into a list and isEdge scans it
+template <class Vertex>
+class packed_csr {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	static constexpr Id none = csr<Vertex>::none;
+
+	// forward iterator decoding one neighbor list
+	class iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Id value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Id* pointer;
+		typedef const Id& reference;
+
+		iterator() : _p(nullptr), _left(0), _k(0), _ctrl(0), _w(0) { }
+
+		// list of deg neighbors of v whose groups start at p
+		iterator(const std::uint8_t *p, Id v, Id deg) : _p(p), _left(deg), _k(0), _ctrl(0), _w(0) {
+			if (_left != 0) {
+				std::uint32_t z = gap();
+				_w = v + ((z >> 1) ^ -(z & 1));
+			}
+		}
+
+		reference operator * () const {
+			return _w;
+		}
+
+		pointer operator -> () const {
+			return &_w;
+		}
+
+		iterator& operator ++ () {
+			if (--_left != 0) {
+				_w += gap();
+			}
+			return *this;
+		}
+
+		iterator operator ++ (int) {
+			iterator ans(*this);
+			++(*this);
+			return ans;
+		}
+
+		// only iterators over the same list compare
+		bool operator == (const iterator &o) const {
+			return _left == o._left;
+		}
+
+		bool operator != (const iterator &o) const {
+			return _left != o._left;
+		}
+
+	private:
+		const std::uint8_t *_p;		// next undecoded byte
+		Id _left;					// neighbors not yet passed, current included
+		unsigned _k;				// gaps decoded from the current group
+		std::uint8_t _ctrl;			// lengths of the gaps left in the group
+		Id _w;						// current neighbor
+
+		// next gap, reading a control byte at the start of each group, the
+		// four byte load may run into the padding after the last list
+		std::uint32_t gap() {
+			if ((_k++ & 3) == 0) {
+				_ctrl = *_p++;
+			}
+			unsigned len = (_ctrl & 3) + 1;
+			_ctrl >>= 2;
+			std::uint32_t x;
+			std::memcpy(&x, _p, sizeof(x));
+			_p += len;
+			return x & (std::uint32_t(-1) >> (32 - 8*len));
+		}
+	};
+	typedef iterator const_iterator;
+
+	// decoded range of adjacent vertex ids
+	struct Range {
+		iterator first, last;
+		std::size_t count;
+
+		iterator begin() const { return first; }
+		iterator end() const { return last; }
+		std::size_t size() const { return count; }
+	};
+
+	// empty snapshot
+	packed_csr() : _directed(false), _loops(0), _arcs(0), _base(1, 0), _rel(1, 0), _data(pad, 0) { }
+
+	// packed copy of a csr snapshot
+	explicit packed_csr(const csr<Vertex> &S) : _directed(S.directed()), _loops(S.loops()), _arcs(0), _label(S.labels()) {
+		index();
+		start();
+		for (Id v = 0; v < n(); v++) {
+			typename csr<Vertex>::Range a = S.Adj(v);
+			append(v, a.begin(), a.end());
+		}
+		finish();
+	}
+
+	// packed snapshot of a graph, every edge is stored in both directions,
+	// built one neighbor list at a time without an unpacked copy
+	template <class Adjacency>
+	explicit packed_csr(const graph<Vertex, Adjacency> &G) : _directed(false), _loops(0), _arcs(0) {
+		build(G);
+	}
+
+	// packed snapshot of a digraph, only out edges are stored
+	template <class Adjacency>
+	explicit packed_csr(const digraph<Vertex, Adjacency> &D) : _directed(true), _loops(0), _arcs(0) {
+		build(D);
+	}
+
+	// number of vertices
+	std::size_t n() const {
+		return _label.size();
+	}
+
+	// number of edges
+	std::size_t m() const {
+		return _directed ? _arcs : (_arcs + _loops)/2;
+	}
+
+	// number of stored neighbor entries
+	std::size_t arcs() const {
+		return _arcs;
+	}
+
+	// number of self loops, stored once each
+	std::size_t loops() const {
+		return _loops;
+	}
+
+	// true if snapshot of a digraph
+	bool directed() const {
+		return _directed;
+	}
+
+	// bytes of adjacency storage, neighbor lists and offsets
+	std::size_t bytes() const {
+		return _data.size() + _base.size()*sizeof(std::uint64_t) + _rel.size()*sizeof(std::uint32_t);
+	}
+
+	// return true if vertex is in snapshot
+	bool isVertex(const Vertex &v) const {
+		return (_id.count(v) != 0);
+	}
+
+	// return true if edge is in snapshot
+	bool isEdge(Id v, Id w) const {
+		for (Id x : Adj(v)) {
+			if (x >= w) {
+				return (x == w);
+			}
+		}
+		return false;
+	}
+
+	// return dense id of vertex
+	Id id(const Vertex &v) const {
+		assert(isVertex(v));
+		return _id.at(v);
+	}
+
+	// return vertex with dense id
+	const Vertex& vertex(Id i) const {
+		assert(i < n());
+		return _label[i];
+	}
+
+	// return range decoding the adjacent vertex ids
+	Range Adj(Id v) const {
+		assert(v < n());
+		const std::uint8_t *p = list(v);
+		Id d = varint(p);
+		return Range{iterator(p, v, d), iterator(), d};
+	}
+
+	// return degree / out degree of vertex id
+	std::size_t deg(Id v) const {
+		assert(v < n());
+		const std::uint8_t *p = list(v);
+		return varint(p);
+	}
+
+	// vertex labels indexed by id
+	const std::vector<Vertex>& labels() const {
+		return _label;
+	}
+
+private:
+	// readable bytes past the last list, for the four byte loads of gap()
+	static constexpr std::size_t pad = 3;
+
+	// vertices sharing one 64 bit base offset
+	static constexpr unsigned shift = 6;
+
+	bool _directed;
+	std::size_t _loops;
+	std::size_t _arcs;
+	std::vector<std::uint64_t> _base;		// list of v at _base[v >> shift] + _rel[v]
+	std::vector<std::uint32_t> _rel;
+	std::vector<std::uint8_t> _data;		// neighbor lists then pad bytes
+	std::vector<Vertex> _label;				// id -> vertex
+	std::unordered_map<Vertex, Id> _id;		// vertex -> id
+
+	const std::uint8_t* list(Id v) const {
+		return _data.data() + _base[v >> shift] + _rel[v];
+	}
+
+	// read a little endian base 128 varint and move past it
+	static Id varint(const std::uint8_t *&p) {
+		Id x(0);
+		for (unsigned s = 0; ; s += 7) {
+			std::uint8_t b = *p++;
+			x |= Id(b & 0x7f) << s;
+			if (b < 0x80) {
+				return x;
+			}
+		}
+	}
+
+	void put_varint(Id x) {
+		while (x >= 0x80) {
+			_data.push_back(std::uint8_t(x) | 0x80);
+			x >>= 7;
+		}
+		_data.push_back(std::uint8_t(x));
+	}
+
+	// fill vertex -> id from the labels
+	void index() {
+		assert(n() < none);
+		_id.reserve(n());
+		for (Id v = 0; v < n(); v++) {
+			_id[_label[v]] = v;
+		}
+	}
+
+	void start() {
+		_base.reserve((n() >> shift) + 1);
+		_rel.reserve(n() + 1);
+	}
+
+	// pack the sorted neighbors [first, last) of v as the next list
+	template <class It>
+	void append(Id v, It first, It last) {
+		std::size_t at = _data.size();
+		if ((v & ((Id(1) << shift) - 1)) == 0) {
+			_base.push_back(at);
+		}
+		assert(at - _base.back() <= std::numeric_limits<std::uint32_t>::max());
+		_rel.push_back(std::uint32_t(at - _base.back()));
+
+		Id d = Id(std::distance(first, last));
+		put_varint(d);
+		_arcs += d;
+
+		std::size_t ctrl(0);
+		Id prev(v);
+		for (Id k = 0; first != last; ++first, k++) {
+			std::uint32_t x;
+			if (k == 0) {
+				// zigzag of the wrapped difference, the first neighbor may
+				// come before v
+				std::uint32_t g = *first - v;
+				x = (g << 1) ^ -(g >> 31);
+			} else {
+				assert(*first >= prev);
+				x = *first - prev;
+			}
+			prev = *first;
+
+			if ((k & 3) == 0) {
+				ctrl = _data.size();
+				_data.push_back(0);
+			}
+			unsigned len = (x < (1u << 8)) ? 1 : (x < (1u << 16)) ? 2 : (x < (1u << 24)) ? 3 : 4;
+			_data[ctrl] |= std::uint8_t((len - 1) << (2*(k & 3)));
+			for (unsigned b = 0; b < len; b++) {
+				_data.push_back(std::uint8_t(x >> (8*b)));
+			}
+		}
+	}
+
+	// close the offsets and pad the last list
+	void finish() {
+		if ((n() & ((std::size_t(1) << shift) - 1)) == 0) {
+			_base.push_back(_data.size());
+		}
+		_rel.push_back(std::uint32_t(_data.size() - _base.back()));
+		_data.insert(_data.end(), pad, 0);
+		_data.shrink_to_fit();
+	}
+
+	template <class G>
+	void build(const G &g) {
+		assert(g.n() < none);
+
+		_label.assign(g.V().begin(), g.V().end());
+		index();
+		start();
+
+		std::vector<Id> adj;
+		for (Id v = 0; v < n(); v++) {
+			adj.clear();
+			for (auto &w : g.Adj(_label[v])) {
+				Id i = _id.at(w);
+				adj.push_back(i);
+				if (i == v) {
+					_loops++;
+				}
+			}
+			std::sort(adj.begin(), adj.end());
+			append(v, adj.begin(), adj.end());
+		}
+		finish();
+	}
+
+};
+
+#endif // PACKED_H
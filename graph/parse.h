@@ -0,0 +1,564 @@
+#ifndef PARSE_H
+#define PARSE_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <atomic>
+#include <algorithm>
+#include <charconv>
+#include <type_traits>
+#include <utility>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+
+#include "csr.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include "stats.h"
+
+// vertex with the given text label
+template <class Vertex>
+Vertex parse_label(std::string_view s) {
+	if constexpr (std::is_integral<Vertex>::value && !std::is_same<Vertex, bool>::value) {
+		Vertex v{};
+		std::from_chars(s.data(), s.data() + s.size(), v);
+		return v;
+	} else if constexpr (std::is_constructible<Vertex, std::string_view>::value) {
+		return Vertex(s);
+	} else {
+		Vertex v;
+		std::istringstream is{std::string(s)};
+		is >> v;
+		return v;
+	}
+}
+
+// fast reader for the text format of operator >> of the graph classes
+//
+//   n m
+//   n vertex labels
+//   m edges "v w" or "v w c", one edge per line
+//
+// the file is mapped, the edge lines are cut into newline aligned chunks
+// that are parsed in parallel with std::from_chars, and the per chunk
+// buffers are merged in input order; labels are matched as text and edges
+// with an unknown end are dropped like addEdge does
+template <class Vertex>
+class text_reader {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	// edge between vertex ids
+	struct edge {
+		Id v, w;
+	};
+
+	text_reader(thread_pool &pool = thread_pool::shared()) : _pool(pool), _weighted(false) { }
+
+	// return true if path holds n vertices and m edges, weighted edges
+	// carry a cost after their ends
+	bool read(const std::string &path, bool weighted = false) {
+		STATS_PHASE("text_reader::read");
+		_label.clear();
+		_edges.clear();
+		_cost.clear();
+		_weighted = weighted;
+
+		auto file = mapped_file::open(path);
+		if (!file) {
+			return false;
+		}
+		const char *p = file->begin(), *end = file->end();
+
+		std::size_t n, m;
+		if (!number(p, end, n) || !number(p, end, m)) {
+			return false;
+		}
+
+		label_table id(n);
+		for (std::size_t i = 0; i < n; i++) {
+			std::string_view t = token(p, end);
+			if (t.empty()) {
+				return false;
+			}
+			id.insert(t);
+		}
+		id.finish();
+
+		// newline aligned chunks of the edge lines
+		std::size_t k = std::max((std::size_t)1, std::min(_pool.size()*chunks, std::size_t(end - p)/min_chunk));
+		std::vector<const char*> cut(k + 1, end);
+		cut[0] = p;
+		for (std::size_t j = 1; j < k; j++) {
+			const char *c = std::max(cut[j-1], p + std::size_t(end - p)*j/k);
+			c = static_cast<const char*>(std::memchr(c, '\n', end - c));
+			cut[j] = c ? c + 1 : end;
+		}
+
+		std::vector<chunk> part(k);
+		_pool.parallel_for(k, 1, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t j = lo; j < hi; j++) {
+				parse(cut[j], cut[j+1], id, part[j]);
+			}
+		});
+
+		// keep the first m lines, a bad line past them is ignored
+		std::size_t used(0), lines(0);
+		while (used < k && lines < m) {
+			lines += part[used].edges.size();
+			if (!part[used].ok && lines < m) {
+				return false;
+			}
+			used++;
+		}
+		if (lines < m) {
+			return false;
+		}
+		if (used > 0) {
+			chunk &last = part[used-1];
+			last.edges.resize(last.edges.size() - (lines - m));
+			last.cost.resize(_weighted ? last.edges.size() : 0);
+		}
+
+		// concatenate the known edges of each chunk
+		std::vector<std::size_t> at(used + 1, 0);
+		for (std::size_t j = 0; j < used; j++) {
+			std::size_t known(0);
+			for (auto &e : part[j].edges) {
+				known += (e.v != csr<Vertex>::none && e.w != csr<Vertex>::none);
+			}
+			at[j+1] = at[j] + known;
+		}
+		_edges.resize(at[used]);
+		_cost.resize(_weighted ? at[used] : 0);
+		_pool.parallel_for(used, 1, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t j = lo; j < hi; j++) {
+				std::size_t a = at[j];
+				for (std::size_t i = 0; i < part[j].edges.size(); i++) {
+					const edge &e = part[j].edges[i];
+					if (e.v != csr<Vertex>::none && e.w != csr<Vertex>::none) {
+						if (_weighted) {
+							_cost[a] = part[j].cost[i];
+						}
+						_edges[a++] = e;
+					}
+				}
+				std::vector<edge>().swap(part[j].edges);
+				std::vector<double>().swap(part[j].cost);
+			}
+		});
+
+		// labels are converted serially, symbol interning is not thread safe
+		_label.reserve(id.names().size());
+		for (auto &t : id.names()) {
+			_label.push_back(parse_label<Vertex>(t));
+		}
+
+		return true;
+	}
+
+	// number of distinct vertices
+	std::size_t n() const {
+		return _label.size();
+	}
+
+	// number of edges read, repeated edges included
+	std::size_t m() const {
+		return _edges.size();
+	}
+
+	// true if edges carry a cost
+	bool weighted() const {
+		return _weighted;
+	}
+
+	// vertices in order of first appearance, indexed by id
+	const std::vector<Vertex>& labels() const {
+		return _label;
+	}
+
+	// edges in input order
+	const std::vector<edge>& edges() const {
+		return _edges;
+	}
+
+	// cost of each edge, empty if not weighted
+	const std::vector<double>& costs() const {
+		return _cost;
+	}
+
+	// add the vertices and edges to g in input order; graph containers are
+	// not thread safe so this step is serial
+	template <class G>
+	void fill(G &g) const {
+		for (auto &v : _label) {
+			g.addVertex(v);
+		}
+		for (std::size_t i = 0; i < _edges.size(); i++) {
+			const Vertex &v = _label[_edges[i].v], &w = _label[_edges[i].w];
+			if constexpr (takes_cost<G>::value) {
+				assert(_weighted);
+				g.addEdge(v, w, _cost[i]);
+			} else {
+				g.addEdge(v, w);
+			}
+		}
+	}
+
+	// csr snapshot built in parallel without a graph in between, an
+	// undirected snapshot stores each edge both ways; repeated edges are
+	// stored once and cost[a] gets the cost of arc a from the first (or
+	// last) occurrence of its edge
+	csr<Vertex> snapshot(bool directed, std::vector<double> *cost = nullptr, bool last = false) const {
+		assert(cost == nullptr || _weighted);
+		STATS_PHASE("text_reader::snapshot");
+		// arcs only carry their edge when a cost has to be looked up
+		if (cost) {
+			return build<arc>(directed, cost, last);
+		}
+		return build<Id>(directed, cost, last);
+	}
+
+private:
+	static constexpr std::size_t chunks = 8;				// chunks per worker
+	static constexpr std::size_t min_chunk = 1 << 16;		// bytes
+	static constexpr std::size_t buckets = 1 << 10;			// partitions of the arcs
+	static constexpr std::size_t vgrain = 1 << 10;			// vertices per task
+
+	thread_pool &_pool;
+	bool _weighted;
+	std::vector<Vertex> _label;
+	std::vector<edge> _edges;
+	std::vector<double> _cost;
+
+	// index of the vertex labels, read only once built so chunks share it;
+	// labels that are all small decimal numbers index an array directly,
+	// others go through an open addressing table whose slots hold a tag of
+	// the hash so a probe rarely touches the label text
+	class label_table {
+	public:
+		explicit label_table(std::size_t n) : _numeric(true), _max(0) {
+			std::size_t size(16);
+			while (size < 2*n) {
+				size *= 2;
+			}
+			_slot.assign(size, slot{csr<Vertex>::none, 0});
+			_mask = size - 1;
+			_name.reserve(n);
+		}
+
+		// add label if new
+		void insert(std::string_view t) {
+			std::uint64_t h = hash(t);
+			std::size_t i = h & _mask;
+			while (_slot[i].id != csr<Vertex>::none) {
+				if (_slot[i].tag == std::uint32_t(h >> 32) && _name[_slot[i].id] == t) {
+					return;
+				}
+				i = (i + 1) & _mask;
+			}
+			assert(_name.size() < csr<Vertex>::none);
+			_slot[i] = slot{Id(_name.size()), std::uint32_t(h >> 32)};
+			_name.push_back(t);
+
+			std::size_t x;
+			_numeric = _numeric && decimal(t, x);
+			_max = _numeric ? std::max(_max, x) : 0;
+		}
+
+		// done inserting, build the direct index if the labels allow it
+		void finish() {
+			std::vector<slot>().swap(_slot);
+			_numeric = _numeric && _max < 4*_name.size() + 1024;
+			if (!_numeric) {
+				rehash();
+				return;
+			}
+			_direct.assign(_max + 1, csr<Vertex>::none);
+			for (Id v = 0; v < _name.size(); v++) {
+				std::size_t x(0);
+				decimal(_name[v], x);
+				_direct[x] = v;
+			}
+		}
+
+		// id of label, none if unknown
+		Id find(std::string_view t) const {
+			if (_numeric) {
+				std::size_t x;
+				return (decimal(t, x) && x <= _max) ? _direct[x] : csr<Vertex>::none;
+			}
+			std::uint64_t h = hash(t);
+			std::size_t i = h & _mask;
+			while (_slot[i].id != csr<Vertex>::none
+				&& (_slot[i].tag != std::uint32_t(h >> 32) || _name[_slot[i].id] != t)) {
+				i = (i + 1) & _mask;
+			}
+			return _slot[i].id;
+		}
+
+		// labels in order of insertion
+		const std::vector<std::string_view>& names() const {
+			return _name;
+		}
+
+	private:
+		struct slot {
+			Id id;
+			std::uint32_t tag;
+		};
+
+		std::vector<slot> _slot;
+		std::vector<Id> _direct;				// number -> id
+		std::vector<std::string_view> _name;
+		std::size_t _mask;
+		bool _numeric;
+		std::size_t _max;
+
+		// refill the table from the names
+		void rehash() {
+			_slot.assign(_mask + 1, slot{csr<Vertex>::none, 0});
+			for (Id v = 0; v < _name.size(); v++) {
+				std::uint64_t h = hash(_name[v]);
+				std::size_t i = h & _mask;
+				while (_slot[i].id != csr<Vertex>::none) {
+					i = (i + 1) & _mask;
+				}
+				_slot[i] = slot{v, std::uint32_t(h >> 32)};
+			}
+		}
+
+		// true if t is a decimal number without leading zeros
+		static bool decimal(std::string_view t, std::size_t &x) {
+			if (t.empty() || t.size() > 9 || (t[0] == '0' && t.size() > 1)) {
+				return false;
+			}
+			x = 0;
+			for (char c : t) {
+				if (c < '0' || c > '9') {
+					return false;
+				}
+				x = 10*x + (c - '0');
+			}
+			return true;
+		}
+
+		// FNV-1a with a final mix so the low bits spread
+		static std::uint64_t hash(std::string_view t) {
+			std::uint64_t h = 14695981039346656037ull;
+			for (char c : t) {
+				h = (h ^ (unsigned char)c) * 1099511628211ull;
+			}
+			h ^= h >> 29;
+			h *= 0xbf58476d1ce4e5b9ull;
+			return h ^ (h >> 32);
+		}
+	};
+
+	// edges of one chunk, unknown ends are none
+	struct chunk {
+		std::vector<edge> edges;
+		std::vector<double> cost;
+		bool ok = true;
+	};
+
+	// arc to w stored for edge e
+	struct arc {
+		Id w;
+		std::size_t e;
+	};
+
+	// true if G has addEdge(v, w, c)
+	template <class G, class = void>
+	struct takes_cost : std::false_type { };
+
+	template <class G>
+	struct takes_cost<G, std::void_t<decltype(std::declval<G&>().addEdge(
+		std::declval<const Vertex&>(), std::declval<const Vertex&>(), 0.0))> > : std::true_type { };
+
+	static bool space(char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+	}
+
+	// next whitespace separated token, empty at end
+	static std::string_view token(const char *&p, const char *end) {
+		while (p < end && space(*p)) {
+			p++;
+		}
+		const char *s = p;
+		while (p < end && !space(*p)) {
+			p++;
+		}
+		return std::string_view(s, p - s);
+	}
+
+	template <class T>
+	static bool number(const char *&p, const char *end, T &x) {
+		std::string_view t = token(p, end);
+		if (!t.empty() && t[0] == '+') {
+			t.remove_prefix(1);
+		}
+		auto r = std::from_chars(t.data(), t.data() + t.size(), x);
+		return !t.empty() && r.ec == std::errc() && r.ptr == t.data() + t.size();
+	}
+
+	// the arcs are radix partitioned by tail into buckets of consecutive
+	// vertices so every write goes to one of a few sequential streams, each
+	// bucket is then placed, sorted and deduplicated in cache; T is Id or arc
+	template <class T>
+	csr<Vertex> build(bool directed, std::vector<double> *cost, bool last) const {
+		std::size_t n = _label.size(), E = _edges.size(), P = _pool.size();
+		unsigned shift(0);
+		while ((n >> shift) >= buckets) {
+			shift++;
+		}
+		std::size_t nb = (n >> shift) + 1;
+
+		// arcs of every part of the edges in every bucket
+		std::vector<std::size_t> pos(P*nb, 0);
+		_pool.run([&](std::size_t i) {
+			std::size_t *count = &pos[i*nb];
+			for (std::size_t k = E*i/P; k < E*(i+1)/P; k++) {
+				const edge &e = _edges[k];
+				count[e.v >> shift]++;
+				if (!directed && e.v != e.w) {
+					count[e.w >> shift]++;
+				}
+			}
+		});
+		std::vector<std::size_t> bstart(nb + 1, 0);
+		for (std::size_t b = 0, s = 0; b < nb; b++) {
+			bstart[b] = s;
+			for (std::size_t i = 0; i < P; i++) {
+				std::size_t c = pos[i*nb + b];
+				pos[i*nb + b] = s;
+				s += c;
+			}
+			bstart[b+1] = s;
+		}
+
+		// scatter (tail, arc) in edge order
+		std::vector< std::pair<Id, T> > part(bstart[nb]);
+		_pool.run([&](std::size_t i) {
+			std::size_t *at = &pos[i*nb];
+			for (std::size_t k = E*i/P; k < E*(i+1)/P; k++) {
+				const edge &e = _edges[k];
+				part[at[e.v >> shift]++] = std::make_pair(e.v, make<T>(e.w, k));
+				if (!directed && e.v != e.w) {
+					part[at[e.w >> shift]++] = std::make_pair(e.w, make<T>(e.v, k));
+				}
+			}
+		});
+		std::vector<std::size_t>().swap(pos);
+
+		// place every bucket, sort each list and keep one arc per neighbor
+		// at the front of its list; start[v] is where list v begins and
+		// off[v] its length until the prefix sum below
+		std::vector<T> A(bstart[nb]);
+		std::vector<std::size_t> start(n + 1, 0), off(n + 1, 0);
+		_pool.parallel_for(nb, 1, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t b = lo; b < hi; b++) {
+				Id first = b << shift, stop = std::min(n, (b + 1) << shift);
+				for (std::size_t a = bstart[b]; a < bstart[b+1]; a++) {
+					start[part[a].first]++;
+				}
+				for (std::size_t v = first, s = bstart[b]; v < stop; v++) {
+					std::size_t d = start[v];
+					start[v] = s;
+					s += d;
+				}
+				for (std::size_t a = bstart[b]; a < bstart[b+1]; a++) {
+					Id v = part[a].first;
+					A[start[v] + off[v]++] = part[a].second;
+				}
+				for (Id v = first; v < stop; v++) {
+					auto i = A.begin() + start[v], j = i + off[v];
+					std::sort(i, j, [last](const T &x, const T &y) {
+						if (target(x) != target(y)) {
+							return target(x) < target(y);
+						}
+						if constexpr (std::is_same<T, arc>::value) {
+							return last ? x.e > y.e : x.e < y.e;
+						}
+						return false;
+					});
+					off[v] = std::unique(i, j, [](const T &x, const T &y) {
+						return target(x) == target(y);
+					}) - i;
+				}
+			}
+		});
+		std::vector< std::pair<Id, T> >().swap(part);
+		start[n] = bstart[nb];
+		for (std::size_t v = 0, s = 0; v <= n; v++) {
+			std::size_t d = off[v];
+			off[v] = s;
+			s += d;
+		}
+
+		std::vector<Id> adj(off[n]);
+		if (cost) {
+			cost->assign(off[n], 0.0);
+		}
+		_pool.parallel_for(n, vgrain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				for (std::size_t a = off[v], b = start[v]; a < off[v+1]; a++, b++) {
+					adj[a] = target(A[b]);
+					if constexpr (std::is_same<T, arc>::value) {
+						(*cost)[a] = _cost[A[b].e];
+					}
+				}
+			}
+		});
+
+		return csr<Vertex>(_label, std::move(off), std::move(adj), directed);
+	}
+
+	template <class T>
+	static T make(Id w, std::size_t e) {
+		if constexpr (std::is_same<T, arc>::value) {
+			return arc{w, e};
+		} else {
+			return w;
+		}
+	}
+
+	static Id target(Id w) {
+		return w;
+	}
+
+	static Id target(const arc &a) {
+		return a.w;
+	}
+
+	// parse the lines of [p, end), stopping at the first bad line
+	void parse(const char *p, const char *end, const label_table &id, chunk &out) const {
+		while (p < end) {
+			const char *eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			if (eol == nullptr) {
+				eol = end;
+			}
+
+			std::string_view v = token(p, eol);
+			if (!v.empty()) {
+				std::string_view w = token(p, eol);
+				double c(0.0);
+				if (w.empty() || (_weighted && !number(p, eol, c)) || !token(p, eol).empty()) {
+					out.ok = false;
+					return;
+				}
+				out.edges.push_back(edge{id.find(v), id.find(w)});
+				if (_weighted) {
+					out.cost.push_back(c);
+				}
+			}
+			p = eol + (eol < end);
+		}
+	}
+
+};
+
+#endif // PARSE_H
@@ -0,0 +1,157 @@
+#ifndef PBFS_H
+#define PBFS_H
+
+#include <unordered_map>
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <algorithm>
+
+#include "csr.h"
+#include "thread_pool.h"
+#include "stats.h"
+
+// level synchronous Breadth First Search on a csr snapshot
+// each frontier is expanded across a thread pool, vertices are claimed
+// with compare-and-swap on their parent and every worker fills its own
+// next frontier buffer
+template <class Vertex>
+class PBFS {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	PBFS(const csr<Vertex> &G, const Vertex &start = Vertex(), thread_pool &pool = thread_pool::shared())
+		: _pool(pool), _parent(G.n()), _local(pool.size()) {
+		STATS_PHASE("PBFS");
+		_ncc = 0;
+		_dD.assign(G.n(), inf);
+		_dC.assign(G.n(), 0);
+		for (auto &p : _parent) {
+			p.store(csr<Vertex>::none, std::memory_order_relaxed);
+		}
+
+		if (G.isVertex(start)) {
+			bfs_one(G, G.id(start));
+			_ncc++;
+		}
+
+		for (Id v = 0; v < G.n(); v++) {
+			if (_dD[v] == inf) {
+				bfs_one(G, v);
+				_ncc++;
+			}
+		}
+
+		_D.reserve(G.n());
+		_C.reserve(G.n());
+		_P.reserve(G.n());
+		for (Id v = 0; v < G.n(); v++) {
+			_D[G.vertex(v)] = _dD[v];
+			_C[G.vertex(v)] = _dC[v];
+			Id p = _parent[v].load(std::memory_order_relaxed);
+			if (p != v) {
+				_P[G.vertex(v)] = G.vertex(p);
+			}
+		}
+	}
+
+	void bfs_one(const csr<Vertex> &G, Id v) {
+		std::size_t depth(0);
+		_parent[v].store(v, std::memory_order_relaxed);
+		_dD[v] = 0;
+		_dC[v] = _ncc;
+		_front.assign(1, v);
+
+		while (!_front.empty()) {
+			depth++;
+
+			// small frontiers are not worth waking the pool for
+			if (_front.size() < grain) {
+				_next.clear();
+				for (Id f : _front) {
+					for (Id w : G.Adj(f)) {
+						if (_parent[w].load(std::memory_order_relaxed) == csr<Vertex>::none) {
+							_parent[w].store(f, std::memory_order_relaxed);
+							_dD[w] = depth;
+							_dC[w] = _ncc;
+							_next.push_back(w);
+						}
+					}
+				}
+				std::swap(_front, _next);
+				continue;
+			}
+
+			_pool.parallel_for(_front.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t i) {
+				std::vector<Id> &out = _local[i];
+				for (std::size_t k = lo; k < hi; k++) {
+					Id f = _front[k];
+					for (Id w : G.Adj(f)) {
+						Id none = csr<Vertex>::none;
+						if (_parent[w].load(std::memory_order_relaxed) == none
+							&& _parent[w].compare_exchange_strong(none, f, std::memory_order_relaxed)) {
+							_dD[w] = depth;
+							_dC[w] = _ncc;
+							out.push_back(w);
+						}
+					}
+				}
+			});
+
+			// concatenate the per worker buffers into the next frontier
+			std::size_t total(0);
+			for (auto &out : _local) {
+				total += out.size();
+			}
+			_next.resize(total);
+			std::vector<std::size_t> at(_local.size());
+			for (std::size_t i = 0, s = 0; i < _local.size(); i++) {
+				at[i] = s;
+				s += _local[i].size();
+			}
+			_pool.run([&](std::size_t i) {
+				std::copy(_local[i].begin(), _local[i].end(), _next.begin() + at[i]);
+				_local[i].clear();
+			});
+			std::swap(_front, _next);
+		}
+	}
+
+	// distances of each vertex to root of component
+	std::unordered_map<Vertex, std::size_t> distances() const {
+		return _D;
+	}
+
+	// parents of each vertex in Breadth First Tree
+	std::unordered_map<Vertex, Vertex> bfTree() const {
+		return _P;
+	}
+
+	// component ids for each vertex
+	std::unordered_map<Vertex, std::size_t> components() const {
+		return _C;
+	}
+
+	// number of connected components
+	std::size_t ncc() const {
+		return _ncc;
+	}
+
+private:
+	static constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+	static constexpr std::size_t grain = 256;		// frontier vertices per task
+
+	thread_pool &_pool;
+	std::size_t _ncc;
+	std::unordered_map<Vertex, std::size_t> _D, _C;
+	std::unordered_map<Vertex, Vertex> _P;
+
+	// dense state, roots are their own parent
+	std::vector< std::atomic<Id> > _parent;
+	std::vector<std::size_t> _dD, _dC;
+	std::vector<Id> _front, _next;
+	std::vector< std::vector<Id> > _local;			// next frontier of each worker
+
+};
+
+#endif // PBFS_H
@@ -0,0 +1,151 @@
+#ifndef PCC_H
+#define PCC_H
+
+#include <unordered_map>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <cassert>
+
+#include "csr.h"
+#include "thread_pool.h"
+#include "stats.h"
+
+// parallel connected components on a csr snapshot of a graph
+// Afforest (Sutton et al.): link a few neighbors of every vertex, find the
+// largest component by sampling, then link the remaining edges of vertices
+// outside it; linking always hooks the larger root below the smaller one
+template <class Vertex>
+class PCC {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	PCC(const csr<Vertex> &G, thread_pool &pool = thread_pool::shared()) : _comp(G.n()) {
+		STATS_PHASE("PCC");
+		assert(!G.directed());
+		array_view<std::size_t> off = G.offsets();
+		array_view<Id> adj = G.targets();
+
+		pool.parallel_for(G.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				_comp[v].store(v, std::memory_order_relaxed);
+			}
+		});
+
+		// link the first few neighbors of every vertex
+		for (std::size_t r = 0; r < rounds; r++) {
+			pool.parallel_for(G.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (std::size_t v = lo; v < hi; v++) {
+					if (off[v] + r < off[v+1]) {
+						link(v, adj[off[v] + r]);
+					}
+				}
+			});
+			compress(pool, G.n());
+		}
+
+		// skip the largest intermediate component, every edge leaving it
+		// is also seen from the other side
+		Id c = sample(G.n());
+		pool.parallel_for(G.n(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				if (_comp[v].load(std::memory_order_relaxed) == c) {
+					continue;
+				}
+				for (std::size_t a = off[v] + rounds; a < off[v+1]; a++) {
+					link(v, adj[a]);
+				}
+			}
+		});
+		compress(pool, G.n());
+
+		// roots are the smallest id of their component, so numbering by
+		// first appearance matches the order BFS finds components in
+		std::vector<std::size_t> number(G.n(), G.n());
+		_ncc = 0;
+		_C.reserve(G.n());
+		for (Id v = 0; v < G.n(); v++) {
+			Id r = _comp[v].load(std::memory_order_relaxed);
+			if (number[r] == G.n()) {
+				number[r] = _ncc++;
+			}
+			_C[G.vertex(v)] = number[r];
+		}
+	}
+
+	// component ids for each vertex
+	std::unordered_map<Vertex, std::size_t> components() const {
+		return _C;
+	}
+
+	// number of connected components
+	std::size_t ncc() const {
+		return _ncc;
+	}
+
+private:
+	static constexpr std::size_t grain = 1024;		// vertices per task
+	static constexpr std::size_t rounds = 2;		// neighbors linked before sampling
+	static constexpr std::size_t samples = 1024;
+
+	std::vector< std::atomic<Id> > _comp;			// parent in the component forest
+	std::size_t _ncc;
+	std::unordered_map<Vertex, std::size_t> _C;
+
+	// join the trees of u and v
+	void link(Id u, Id v) {
+		Id p1 = _comp[u].load(std::memory_order_relaxed);
+		Id p2 = _comp[v].load(std::memory_order_relaxed);
+		while (p1 != p2) {
+			Id high = std::max(p1, p2);
+			Id low = std::min(p1, p2);
+			Id ph = _comp[high].load(std::memory_order_relaxed);
+			if (ph == low) {
+				break;
+			}
+			if (ph == high && _comp[high].compare_exchange_strong(ph, low, std::memory_order_relaxed)) {
+				break;
+			}
+			p1 = _comp[_comp[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+			p2 = _comp[low].load(std::memory_order_relaxed);
+		}
+	}
+
+	// point every vertex directly at its root
+	void compress(thread_pool &pool, std::size_t n) {
+		pool.parallel_for(n, grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (std::size_t v = lo; v < hi; v++) {
+				Id p = _comp[v].load(std::memory_order_relaxed);
+				while (p != _comp[p].load(std::memory_order_relaxed)) {
+					p = _comp[p].load(std::memory_order_relaxed);
+				}
+				_comp[v].store(p, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	// most frequent root among randomly sampled vertices
+	Id sample(std::size_t n) {
+		if (n == 0) {
+			return csr<Vertex>::none;
+		}
+
+		std::mt19937 gen(27491095);
+		std::uniform_int_distribution<std::size_t> pick(0, n-1);
+		std::unordered_map<Id, std::size_t> count;
+		Id ans(0);
+		std::size_t best(0);
+		for (std::size_t i = 0; i < samples; i++) {
+			Id r = _comp[pick(gen)].load(std::memory_order_relaxed);
+			if (++count[r] > best) {
+				best = count[r];
+				ans = r;
+			}
+		}
+		return ans;
+	}
+
+};
+
+#endif // PCC_H
@@ -0,0 +1,448 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+
+#include "csr.h"
+#include "stats.h"
+
+// vertex orderings of a csr snapshot for cache locality, each returns a
+// permutation perm where perm[v] is the new id of id v, and reorder()
+// relabels the snapshot with it. labels move with their ids, so searches
+// on the relabeled snapshot still translate back to the original vertices
+//
+//   csr<int> R = reorder(S, rcm_order(S));
+//   BFS<int> b(R, s);
+//
+// digraph snapshots are ordered by their out and in neighbors together
+
+// new snapshot with id v renamed perm[v], cost (aligned with targets(),
+// see arc_costs) is permuted along with the arcs if given
+template <class Vertex>
+csr<Vertex> reorder(const csr<Vertex> &S, const std::vector<typename csr<Vertex>::Id> &perm,
+		std::vector<double> *cost = nullptr) {
+	STATS_PHASE("reorder");
+	typedef typename csr<Vertex>::Id Id;
+	assert(perm.size() == S.n());
+	assert(cost == nullptr || cost->size() == S.arcs());
+
+	std::vector<Id> old(S.n());
+	for (Id v = 0; v < S.n(); v++) {
+		assert(perm[v] < S.n());
+		old[perm[v]] = v;
+	}
+
+	std::vector<Vertex> labels(S.n());
+	std::vector<std::size_t> off(S.n()+1, 0);
+	for (Id u = 0; u < S.n(); u++) {
+		labels[u] = S.vertex(old[u]);
+		off[u+1] = off[u] + S.deg(old[u]);
+	}
+
+	array_view<std::size_t> from = S.offsets();
+	array_view<Id> to = S.targets();
+	std::vector<Id> adj(S.arcs());
+	std::vector<double> c(cost ? S.arcs() : 0);
+	std::vector< std::pair<Id, double> > arcs;
+	for (Id u = 0; u < S.n(); u++) {
+		std::size_t a = from[old[u]], b = from[old[u]+1];
+		if (cost == nullptr) {
+			for (std::size_t i = a; i < b; i++) {
+				adj[off[u] + i - a] = perm[to[i]];
+			}
+			std::sort(adj.begin() + off[u], adj.begin() + off[u+1]);
+			continue;
+		}
+
+		arcs.clear();
+		for (std::size_t i = a; i < b; i++) {
+			arcs.push_back(std::make_pair(perm[to[i]], (*cost)[i]));
+		}
+		std::sort(arcs.begin(), arcs.end());
+		for (std::size_t i = 0; i < arcs.size(); i++) {
+			adj[off[u] + i] = arcs[i].first;
+			c[off[u] + i] = arcs[i].second;
+		}
+	}
+
+	if (cost != nullptr) {
+		cost->swap(c);
+	}
+	return csr<Vertex>(std::move(labels), std::move(off), std::move(adj), S.directed());
+}
+
+// in neighbors of a digraph snapshot as offsets and sources
+template <class Vertex>
+void transpose(const csr<Vertex> &S, std::vector<std::size_t> &off, std::vector<typename csr<Vertex>::Id> &src) {
+	typedef typename csr<Vertex>::Id Id;
+	off.assign(S.n()+1, 0);
+	for (Id w : S.targets()) {
+		off[w+1]++;
+	}
+	std::partial_sum(off.begin(), off.end(), off.begin());
+
+	std::vector<std::size_t> next(off.begin(), off.end() - 1);
+	src.resize(S.arcs());
+	for (Id v = 0; v < S.n(); v++) {
+		for (Id w : S.Adj(v)) {
+			src[next[w]++] = v;
+		}
+	}
+}
+
+// neighbors of a snapshot ignoring direction: out neighbors, then in
+// neighbors of a digraph
+template <class Vertex>
+class undirected_view {
+public:
+	typedef typename csr<Vertex>::Id Id;
+
+	explicit undirected_view(const csr<Vertex> &S) : _S(S) {
+		if (S.directed()) {
+			transpose(S, _off, _src);
+		}
+	}
+
+	std::size_t n() const {
+		return _S.n();
+	}
+
+	std::size_t deg(Id v) const {
+		return _S.deg(v) + (_S.directed() ? _off[v+1] - _off[v] : 0);
+	}
+
+	template <class F>
+	void each(Id v, F f) const {
+		for (Id w : _S.Adj(v)) {
+			f(w);
+		}
+		if (_S.directed()) {
+			for (std::size_t a = _off[v]; a < _off[v+1]; a++) {
+				f(_src[a]);
+			}
+		}
+	}
+
+private:
+	const csr<Vertex> &_S;
+	std::vector<std::size_t> _off;
+	std::vector<Id> _src;
+};
+
+// highest degree first, ties keep their id order; packs the hubs that most
+// searches touch into few cache lines
+template <class Vertex>
+std::vector<typename csr<Vertex>::Id> degree_order(const csr<Vertex> &S) {
+	typedef typename csr<Vertex>::Id Id;
+	undirected_view<Vertex> U(S);
+	std::vector<Id> order(S.n());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](Id a, Id b) {
+		return U.deg(a) > U.deg(b);
+	});
+
+	std::vector<Id> perm(S.n());
+	for (Id i = 0; i < S.n(); i++) {
+		perm[order[i]] = i;
+	}
+	return perm;
+}
+
+// breadth first visiting order, from each unvisited id in turn
+template <class Vertex>
+std::vector<typename csr<Vertex>::Id> bfs_order(const csr<Vertex> &S) {
+	typedef typename csr<Vertex>::Id Id;
+	undirected_view<Vertex> U(S);
+	std::vector<Id> perm(S.n(), csr<Vertex>::none), queue;
+	queue.reserve(S.n());
+
+	for (Id r = 0; r < S.n(); r++) {
+		if (perm[r] != csr<Vertex>::none) {
+			continue;
+		}
+		std::size_t head = queue.size();
+		perm[r] = queue.size();
+		queue.push_back(r);
+		while (head < queue.size()) {
+			U.each(queue[head++], [&](Id w) {
+				if (perm[w] == csr<Vertex>::none) {
+					perm[w] = queue.size();
+					queue.push_back(w);
+				}
+			});
+		}
+	}
+	return perm;
+}
+
+// reverse Cuthill-McKee: per component, a breadth first search from a
+// pseudo peripheral vertex (George and Liu) that visits the neighbors of
+// each vertex by increasing degree, the whole order reversed; keeps the
+// ids of every edge's ends close together (small bandwidth)
+template <class Vertex>
+std::vector<typename csr<Vertex>::Id> rcm_order(const csr<Vertex> &S) {
+	STATS_PHASE("rcm_order");
+	typedef typename csr<Vertex>::Id Id;
+	const Id none = csr<Vertex>::none;
+	undirected_view<Vertex> U(S);
+
+	// ids by increasing degree, roots are tried in this order
+	std::vector<Id> byDeg(S.n());
+	std::iota(byDeg.begin(), byDeg.end(), 0);
+	std::stable_sort(byDeg.begin(), byDeg.end(), [&](Id a, Id b) {
+		return U.deg(a) < U.deg(b);
+	});
+
+	std::vector<Id> order, level(S.n(), none), next;
+	std::vector<char> done(S.n(), 0);
+	order.reserve(S.n());
+
+	// levels of the component of r from r, returns the last level's first
+	// index in order; order holds the component afterwards
+	auto levels = [&](Id r, std::size_t base, std::size_t &depth) {
+		order.resize(base);
+		order.push_back(r);
+		level[r] = 0;
+		std::size_t last(base);
+		for (std::size_t head = base; head < order.size(); head++) {
+			Id v = order[head];
+			if (level[v] != level[order[last]]) {
+				last = head;
+			}
+			U.each(v, [&](Id w) {
+				if (level[w] == none) {
+					level[w] = level[v] + 1;
+					order.push_back(w);
+				}
+			});
+		}
+		depth = level[order.back()];
+		for (std::size_t i = base; i < order.size(); i++) {
+			level[order[i]] = none;
+		}
+		return last;
+	};
+
+	for (Id r : byDeg) {
+		if (done[r]) {
+			continue;
+		}
+		std::size_t base = order.size(), depth(0), deeper(0);
+
+		// move the root to a min degree vertex of the last level while
+		// that makes the component deeper
+		std::size_t last = levels(r, base, depth);
+		while (true) {
+			Id x = order[last];
+			for (std::size_t i = last; i < order.size(); i++) {
+				if (U.deg(order[i]) < U.deg(x)) {
+					x = order[i];
+				}
+			}
+			std::size_t l = levels(x, base, deeper);
+			if (deeper <= depth) {
+				break;
+			}
+			r = x;
+			last = l;
+			depth = deeper;
+		}
+
+		// Cuthill-McKee from r
+		order.resize(base);
+		order.push_back(r);
+		done[r] = 1;
+		for (std::size_t head = base; head < order.size(); head++) {
+			next.clear();
+			U.each(order[head], [&](Id w) {
+				if (!done[w]) {
+					done[w] = 1;
+					next.push_back(w);
+				}
+			});
+			std::stable_sort(next.begin(), next.end(), [&](Id a, Id b) {
+				return U.deg(a) < U.deg(b);
+			});
+			order.insert(order.end(), next.begin(), next.end());
+		}
+	}
+
+	std::vector<Id> perm(S.n());
+	for (Id i = 0; i < S.n(); i++) {
+		perm[order[i]] = S.n() - 1 - i;
+	}
+	return perm;
+}
+
+// max heap of scores that only ever change by one (the unit heap of
+// Gorder): a doubly linked list of ids per score, so raising, lowering and
+// finding the max take O(1); ids of score 0 are in no list
+class unit_heap {
+public:
+	typedef std::uint32_t Id;
+
+	static constexpr Id none = std::numeric_limits<Id>::max();
+
+	explicit unit_heap(std::size_t n) : _score(n, 0), _prev(n), _next(n), _head(1, none), _top(0) { }
+
+	std::size_t score(Id v) const {
+		return _score[v];
+	}
+
+	void raise(Id v) {
+		unlink(v);
+		_score[v]++;
+		link(v);
+		_top = std::max(_top, _score[v]);
+	}
+
+	void lower(Id v) {
+		assert(_score[v] > 0);
+		unlink(v);
+		_score[v]--;
+		link(v);
+	}
+
+	// take v out for good
+	void erase(Id v) {
+		unlink(v);
+		_score[v] = 0;
+	}
+
+	// an id of the highest score, none if every score is 0
+	Id max() {
+		while (_top > 0 && _head[_top] == none) {
+			_top--;
+		}
+		return (_top > 0) ? _head[_top] : none;
+	}
+
+private:
+	std::vector<std::size_t> _score;
+	std::vector<Id> _prev, _next, _head;	// lists by score
+	std::size_t _top;						// no list above is non empty
+
+	void link(Id v) {
+		std::size_t k = _score[v];
+		if (k == 0) {
+			return;
+		}
+		if (k >= _head.size()) {
+			_head.resize(2*k, none);
+		}
+		_prev[v] = none;
+		_next[v] = _head[k];
+		if (_head[k] != none) {
+			_prev[_head[k]] = v;
+		}
+		_head[k] = v;
+	}
+
+	void unlink(Id v) {
+		std::size_t k = _score[v];
+		if (k == 0) {
+			return;
+		}
+		if (_prev[v] != none) {
+			_next[_prev[v]] = _next[v];
+		} else {
+			_head[k] = _next[v];
+		}
+		if (_next[v] != none) {
+			_prev[_next[v]] = _prev[v];
+		}
+	}
+};
+
+// Gorder (Wei et al.): greedily append the vertex sharing the most with
+// the last window placed ones, where u scores one per edge to each of them
+// and one per common in neighbor. scores change by one as vertices enter
+// and leave the window; in neighbors of degree above sqrt(n) are not
+// expanded into siblings
+template <class Vertex>
+std::vector<typename csr<Vertex>::Id> gorder(const csr<Vertex> &S, std::size_t window = 5) {
+	STATS_PHASE("gorder");
+	typedef typename csr<Vertex>::Id Id;
+	const Id none = csr<Vertex>::none;
+
+	std::vector<std::size_t> inOff;
+	std::vector<Id> inSrc;
+	if (S.directed()) {
+		transpose(S, inOff, inSrc);
+	}
+	array_view<std::size_t> off = S.offsets();
+	array_view<Id> adj = S.targets();
+	const std::size_t *ioff = S.directed() ? inOff.data() : off.data();
+	const Id *isrc = S.directed() ? inSrc.data() : adj.data();
+	std::size_t hub = std::max<std::size_t>(window, std::sqrt(double(S.n())));
+
+	std::vector<Id> perm(S.n(), none), order;
+	order.reserve(S.n());
+	unit_heap H(S.n());
+
+	// raise (or lower) by one the score of every unplaced vertex related to v
+	auto update = [&](Id v, bool raise) {
+		auto bump = [&](Id u) {
+			if (perm[u] != none) {
+				return;
+			}
+			if (raise) {
+				H.raise(u);
+			} else {
+				H.lower(u);
+			}
+		};
+		for (std::size_t a = off[v]; a < off[v+1]; a++) {
+			bump(adj[a]);
+		}
+		for (std::size_t a = ioff[v]; a < ioff[v+1]; a++) {
+			Id u = isrc[a];
+			if (S.directed()) {
+				bump(u);
+			}
+			if (off[u+1] - off[u] <= hub) {
+				for (std::size_t b = off[u]; b < off[u+1]; b++) {
+					if (adj[b] != v) {
+						bump(adj[b]);
+					}
+				}
+			}
+		}
+	};
+
+	// start each component at its largest in degree, as the paper does
+	std::vector<Id> byIn(S.n());
+	std::iota(byIn.begin(), byIn.end(), 0);
+	std::stable_sort(byIn.begin(), byIn.end(), [&](Id a, Id b) {
+		return ioff[a+1] - ioff[a] > ioff[b+1] - ioff[b];
+	});
+	std::size_t seed(0);
+
+	while (order.size() < S.n()) {
+		Id v = H.max();
+		if (v == none) {
+			while (perm[byIn[seed]] != none) {
+				seed++;
+			}
+			v = byIn[seed];
+		}
+
+		perm[v] = order.size();
+		order.push_back(v);
+		H.erase(v);
+		update(v, true);
+		if (order.size() > window) {
+			update(order[order.size() - window - 1], false);
+		}
+	}
+	return perm;
+}
+
+#endif // REORDER_H
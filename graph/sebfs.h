@@ -0,0 +1,141 @@
+#ifndef SEBFS_H
+#define SEBFS_H
+
+#include <unordered_map>
+#include <vector>
+#include <limits>
+#include <cassert>
+
+#include "edge_file.h"
+#include "secc.h"
+#include "bitmap.h"
+#include "stats.h"
+
+// semi external Breadth First Search of a graph file, the distances,
+// parents and components stay in memory while the edges are streamed
+// one pass per level: a first pass finds the components, then every
+// component is searched at once from its root (start, else its smallest
+// id), each level scanning only the neighbor lists of the frontier
+template <class Vertex>
+class SEBFS {
+public:
+	typedef edge_file::Id Id;
+
+	SEBFS(edge_file &E, const Vertex &start = Vertex()) : _ncc(0), _passes(1) {
+		STATS_PHASE("SEBFS");
+		assert(!E.directed());
+		std::vector<Id> root;
+		_ok = stream_components(E, root) && E.labels(_label);
+		if (!_ok) {
+			return;
+		}
+
+		Id s = none;
+		for (Id v = 0; v < E.n() && s == none; v++) {
+			if (_label[v] == start) {
+				s = v;
+			}
+		}
+
+		// start's component is numbered first, the rest by smallest id
+		_dD.assign(E.n(), inf);
+		_dP.assign(E.n(), none);
+		_dC.assign(E.n(), 0);
+		std::vector<std::size_t> number(E.n(), inf);
+		bitmap front(E.n()), next(E.n());
+		if (s != none) {
+			number[root[s]] = _ncc++;
+			_dD[s] = 0;
+			front.set(s);
+		}
+		for (Id v = 0; v < E.n(); v++) {
+			if (root[v] == v && number[v] == inf) {
+				number[v] = _ncc++;
+				_dD[v] = 0;
+				front.set(v);
+			}
+			_dC[v] = number[root[v]];
+		}
+		std::vector<Id>().swap(root);
+		std::vector<std::size_t>().swap(number);
+		STATS_ADD(bfs_vertices, _ncc);
+
+		for (std::size_t depth = 1, nf = _ncc; nf > 0 && _ok; depth++) {
+			nf = 0;
+			next.clear();
+			_ok = E.scan([&](Id v) { return front.test(v); }, [&](Id v, const Id *first, const Id *last) {
+				for (const Id *w = first; w != last; w++) {
+					STATS_ADD(bfs_edges, 1);
+					if (_dD[*w] == inf) {
+						_dD[*w] = depth;
+						_dP[*w] = v;
+						next.set(*w);
+						nf++;
+					}
+				}
+			});
+			STATS_ADD(bfs_vertices, nf);
+			std::swap(front, next);
+			_passes++;
+		}
+	}
+
+	// false if the file could not be read
+	bool ok() const {
+		return _ok;
+	}
+
+	// distances of each vertex to root of component
+	std::unordered_map<Vertex, std::size_t> distances() const {
+		return translate(_dD);
+	}
+
+	// parents of each vertex in Breadth First Tree
+	std::unordered_map<Vertex, Vertex> bfTree() const {
+		std::unordered_map<Vertex, Vertex> ans;
+		ans.reserve(_label.size());
+		for (Id v = 0; v < _label.size(); v++) {
+			if (_dP[v] != none) {
+				ans[_label[v]] = _label[_dP[v]];
+			}
+		}
+		return ans;
+	}
+
+	// component ids for each vertex
+	std::unordered_map<Vertex, std::size_t> components() const {
+		return translate(_dC);
+	}
+
+	// number of connected components
+	std::size_t ncc() const {
+		return _ncc;
+	}
+
+	// sequential passes over the edges, one for the components and one per level
+	std::size_t passes() const {
+		return _passes;
+	}
+
+private:
+	static constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+	static constexpr Id none = std::numeric_limits<Id>::max();
+
+	bool _ok;
+	std::size_t _ncc, _passes;
+	std::vector<std::size_t> _dD, _dC;		// distance and component of each id
+	std::vector<Id> _dP;					// parent of each id
+	std::vector<Vertex> _label;				// id -> vertex
+
+	std::unordered_map<Vertex, std::size_t> translate(const std::vector<std::size_t> &x) const {
+		std::unordered_map<Vertex, std::size_t> ans;
+		ans.reserve(_label.size());
+		for (Id v = 0; v < _label.size(); v++) {
+			ans[_label[v]] = x[v];
+		}
+		return ans;
+	}
+
+};
+
+#endif // SEBFS_H
@@ -0,0 +1,104 @@
+#ifndef SECC_H
+#define SECC_H
+
+#include <unordered_map>
+#include <vector>
+#include <numeric>
+
+#include "edge_file.h"
+#include "stats.h"
+
+// root of v in a union find forest, halving the path on the way up
+inline edge_file::Id stream_find(std::vector<edge_file::Id> &parent, edge_file::Id v) {
+	STATS_ADD(find_sets, 1);
+	while (parent[v] != v) {
+		STATS_ADD(find_set_path, 1);
+		parent[v] = parent[parent[v]];
+		v = parent[v];
+	}
+	return v;
+}
+
+// label every vertex of E with the smallest id of its (weakly) connected
+// component in one sequential pass, linking each edge into a union find
+// forest that always hooks the larger root below the smaller one
+inline bool stream_components(edge_file &E, std::vector<edge_file::Id> &root) {
+	typedef edge_file::Id Id;
+	bool directed = E.directed();
+	root.resize(E.n());
+	std::iota(root.begin(), root.end(), Id(0));
+
+	bool ok = E.scan([&](Id v, const Id *first, const Id *last) {
+		for (const Id *w = first; w != last; w++) {
+			// an undirected file stores every edge from both ends
+			if (directed || *w > v) {
+				Id a = stream_find(root, v), b = stream_find(root, *w);
+				if (a < b) {
+					root[b] = a;
+				} else if (b < a) {
+					root[a] = b;
+				}
+			}
+		}
+	});
+
+	for (Id v = 0; v < E.n(); v++) {
+		root[v] = root[root[v]];
+	}
+	return ok;
+}
+
+// semi external connected components of a graph file, the edges are read
+// once in order and only 4 bytes per vertex (plus the labels) stay in
+// memory, a digraph gets its weakly connected components
+template <class Vertex>
+class SECC {
+public:
+	typedef edge_file::Id Id;
+
+	SECC(edge_file &E) : _ncc(0) {
+		STATS_PHASE("SECC");
+		std::vector<Id> root;
+		_ok = stream_components(E, root) && E.labels(_label);
+
+		// number components by their smallest id, the order BFS finds them
+		// in; a root is numbered before any other vertex of its component
+		for (Id v = 0; v < E.n(); v++) {
+			if (root[v] == v) {
+				root[v] = _ncc++;
+			} else {
+				root[v] = root[root[v]];
+			}
+		}
+		_dC.swap(root);
+	}
+
+	// false if the file could not be read
+	bool ok() const {
+		return _ok;
+	}
+
+	// component ids for each vertex
+	std::unordered_map<Vertex, std::size_t> components() const {
+		std::unordered_map<Vertex, std::size_t> ans;
+		ans.reserve(_label.size());
+		for (Id v = 0; v < _label.size(); v++) {
+			ans[_label[v]] = _dC[v];
+		}
+		return ans;
+	}
+
+	// number of connected components
+	std::size_t ncc() const {
+		return _ncc;
+	}
+
+private:
+	bool _ok;
+	std::size_t _ncc;
+	std::vector<Id> _dC;				// component of each id
+	std::vector<Vertex> _label;			// id -> vertex
+
+};
+
+#endif // SECC_H
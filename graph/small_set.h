@@ -0,0 +1,391 @@
+#ifndef SMALL_SET_H
+#define SMALL_SET_H
+
+#include <memory_resource>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <algorithm>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+// set of vertices for one adjacency list: up to N vertices are stored
+// inline and scanned linearly, past N they move to an open addressing
+// table with linear probing (at most 3/4 full), and back inline once half
+// of N remain. iteration walks contiguous memory in both cases, and every
+// insert or erase invalidates iterators
+template <class Vertex, std::size_t N = std::max<std::size_t>(2, 32 / sizeof(Vertex))>
+class small_set {
+public:
+	typedef Vertex key_type;
+	typedef Vertex value_type;
+	typedef std::size_t size_type;
+	typedef std::pmr::polymorphic_allocator<Vertex> allocator_type;
+
+	class const_iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Vertex value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Vertex* pointer;
+		typedef const Vertex& reference;
+
+		const_iterator() : _p(nullptr), _e(nullptr), _u(nullptr) { }
+
+		// slots [p, e) with occupancy bytes u, or no u when all are used
+		const_iterator(const Vertex *p, const Vertex *e, const std::uint8_t *u) : _p(p), _e(e), _u(u) {
+			skip();
+		}
+
+		reference operator * () const {
+			return *_p;
+		}
+
+		pointer operator -> () const {
+			return _p;
+		}
+
+		const_iterator& operator ++ () {
+			++_p;
+			if (_u != nullptr) {
+				++_u;
+				skip();
+			}
+			return *this;
+		}
+
+		const_iterator operator ++ (int) {
+			const_iterator ans(*this);
+			++(*this);
+			return ans;
+		}
+
+		bool operator == (const const_iterator &o) const {
+			return _p == o._p;
+		}
+
+		bool operator != (const const_iterator &o) const {
+			return _p != o._p;
+		}
+
+	private:
+		const Vertex *_p, *_e;
+		const std::uint8_t *_u;
+
+		void skip() {
+			if (_u != nullptr) {
+				while (_p != _e && *_u == 0) {
+					++_p;
+					++_u;
+				}
+			}
+		}
+	};
+	typedef const_iterator iterator;
+
+	small_set() : _n(0), _cap(0) { }
+
+	explicit small_set(const allocator_type &a) : _alloc(a), _n(0), _cap(0) { }
+
+	small_set(const small_set &o) : small_set(o, allocator_type()) { }
+
+	small_set(const small_set &o, const allocator_type &a) : _alloc(a), _n(0), _cap(0) {
+		copy(o);
+	}
+
+	small_set(small_set &&o) noexcept : _alloc(o._alloc), _n(0), _cap(0) {
+		steal(o);
+	}
+
+	small_set(small_set &&o, const allocator_type &a) : _alloc(a), _n(0), _cap(0) {
+		if (_alloc == o._alloc) {
+			steal(o);
+		} else {
+			copy(o);
+		}
+	}
+
+	// the allocator stays with the set, as for std::pmr containers
+	small_set& operator = (const small_set &o) {
+		if (this != &o) {
+			clear();
+			copy(o);
+		}
+		return *this;
+	}
+
+	small_set& operator = (small_set &&o) {
+		if (this != &o) {
+			clear();
+			if (_alloc == o._alloc) {
+				steal(o);
+			} else {
+				copy(o);
+			}
+		}
+		return *this;
+	}
+
+	~small_set() {
+		clear();
+	}
+
+	allocator_type get_allocator() const {
+		return _alloc;
+	}
+
+	std::size_t size() const {
+		return _n;
+	}
+
+	bool empty() const {
+		return (_n == 0);
+	}
+
+	const_iterator begin() const {
+		if (_cap == 0) {
+			return const_iterator(in(), in() + _n, nullptr);
+		}
+		return const_iterator(_slots, _slots + _cap, used());
+	}
+
+	const_iterator end() const {
+		if (_cap == 0) {
+			return const_iterator(in() + _n, in() + _n, nullptr);
+		}
+		return const_iterator(_slots + _cap, _slots + _cap, used() + _cap);
+	}
+
+	std::size_t count(const Vertex &v) const {
+		return (find(v) != npos);
+	}
+
+	// add v if not already in set
+	std::pair<const_iterator, bool> insert(const Vertex &v) {
+		std::size_t i = find(v);
+		if (i != npos) {
+			return std::make_pair(at(i), false);
+		}
+
+		if (_cap == 0 && _n < N) {
+			::new (in() + _n) Vertex(v);
+			return std::make_pair(at(_n++), true);
+		}
+		if (4*(_n + 1) > 3*_cap) {
+			rehash((_cap == 0) ? first_table() : 2*_cap);
+		}
+		i = place(v);
+		_n++;
+		return std::make_pair(at(i), true);
+	}
+
+	// remove v, returns the number removed
+	std::size_t erase(const Vertex &v) {
+		std::size_t i = find(v);
+		if (i == npos) {
+			return 0;
+		}
+
+		if (_cap == 0) {
+			Vertex *a = in();
+			if (i != _n - 1) {
+				a[i] = std::move(a[_n - 1]);
+			}
+			a[_n - 1].~Vertex();
+			_n--;
+			return 1;
+		}
+
+		// backward shift deletion, no tombstones
+		std::size_t mask = _cap - 1;
+		std::uint8_t *u = used();
+		_slots[i].~Vertex();
+		u[i] = 0;
+		for (std::size_t j = (i + 1) & mask; u[j] != 0; j = (j + 1) & mask) {
+			std::size_t h = home(_slots[j]);
+			if (((j - h) & mask) >= ((j - i) & mask)) {
+				::new (_slots + i) Vertex(std::move(_slots[j]));
+				_slots[j].~Vertex();
+				u[i] = 1;
+				u[j] = 0;
+				i = j;
+			}
+		}
+		_n--;
+
+		if (_n <= N/2) {
+			rehash(0);
+		}
+		return 1;
+	}
+
+	void clear() {
+		if (_cap == 0) {
+			for (std::size_t i = 0; i < _n; i++) {
+				in()[i].~Vertex();
+			}
+		} else {
+			for (std::size_t i = 0; i < _cap; i++) {
+				if (used()[i] != 0) {
+					_slots[i].~Vertex();
+				}
+			}
+			_alloc.resource()->deallocate(_slots, bytes(_cap), alignof(Vertex));
+			_cap = 0;
+		}
+		_n = 0;
+	}
+
+private:
+	static constexpr std::size_t npos = std::size_t(-1);
+
+	allocator_type _alloc;
+	std::uint32_t _n;			// number of vertices
+	std::uint32_t _cap;			// 0 while inline, else table slots (a power of two)
+	union {
+		alignas(Vertex) unsigned char _inline[N * sizeof(Vertex)];
+		Vertex *_slots;			// followed by _cap occupancy bytes
+	};
+
+	Vertex* in() {
+		return reinterpret_cast<Vertex*>(_inline);
+	}
+
+	const Vertex* in() const {
+		return reinterpret_cast<const Vertex*>(_inline);
+	}
+
+	std::uint8_t* used() const {
+		return reinterpret_cast<std::uint8_t*>(_slots + _cap);
+	}
+
+	// slots of the table vertices move to from inline, a power of two
+	static constexpr std::size_t first_table() {
+		std::size_t cap(1);
+		while (cap < 4*N) {
+			cap *= 2;
+		}
+		return cap;
+	}
+
+	static std::size_t bytes(std::size_t cap) {
+		return cap*sizeof(Vertex) + cap;
+	}
+
+	// first slot probed for v, multiplicative hashing so consecutive
+	// vertices spread over the table
+	std::size_t home(const Vertex &v) const {
+		std::uint64_t h = std::uint64_t(std::hash<Vertex>()(v)) * 0x9e3779b97f4a7c15ull;
+		return (h >> 32) & (_cap - 1);
+	}
+
+	const_iterator at(std::size_t i) const {
+		if (_cap == 0) {
+			return const_iterator(in() + i, in() + _n, nullptr);
+		}
+		return const_iterator(_slots + i, _slots + _cap, used() + i);
+	}
+
+	// slot or inline index of v, npos if absent
+	std::size_t find(const Vertex &v) const {
+		if (_cap == 0) {
+			const Vertex *a = in();
+			for (std::size_t i = 0; i < _n; i++) {
+				if (a[i] == v) {
+					return i;
+				}
+			}
+			return npos;
+		}
+
+		std::size_t mask = _cap - 1;
+		const std::uint8_t *u = used();
+		for (std::size_t i = home(v); u[i] != 0; i = (i + 1) & mask) {
+			if (_slots[i] == v) {
+				return i;
+			}
+		}
+		return npos;
+	}
+
+	// put v, known absent, into the first free slot of the table
+	template <class V>
+	std::size_t place(V &&v) {
+		std::size_t mask = _cap - 1, i = home(v);
+		std::uint8_t *u = used();
+		while (u[i] != 0) {
+			i = (i + 1) & mask;
+		}
+		::new (_slots + i) Vertex(std::forward<V>(v));
+		u[i] = 1;
+		return i;
+	}
+
+	// move every vertex to a table of cap slots, or inline if cap is 0
+	void rehash(std::size_t cap) {
+		alignas(Vertex) unsigned char keep[N * sizeof(Vertex)];
+		Vertex *old = (_cap == 0) ? reinterpret_cast<Vertex*>(keep) : _slots;
+		std::size_t oldCap = _cap, n = _n;
+		std::uint8_t *oldUsed = (_cap == 0) ? nullptr : used();
+
+		if (_cap == 0) {
+			for (std::size_t i = 0; i < n; i++) {
+				::new (old + i) Vertex(std::move(in()[i]));
+				in()[i].~Vertex();
+			}
+		}
+
+		_cap = cap;
+		_n = 0;
+		if (cap != 0) {
+			_slots = static_cast<Vertex*>(_alloc.resource()->allocate(bytes(cap), alignof(Vertex)));
+			std::fill(used(), used() + cap, 0);
+		}
+
+		std::size_t slots = (oldCap == 0) ? n : oldCap;
+		for (std::size_t i = 0; i < slots; i++) {
+			if (oldUsed == nullptr || oldUsed[i] != 0) {
+				if (cap == 0) {
+					::new (in() + _n) Vertex(std::move(old[i]));
+				} else {
+					place(std::move(old[i]));
+				}
+				_n++;
+				old[i].~Vertex();
+			}
+		}
+
+		if (oldCap != 0) {
+			_alloc.resource()->deallocate(old, bytes(oldCap), alignof(Vertex));
+		}
+	}
+
+	void copy(const small_set &o) {
+		if (o._n > N) {
+			rehash(o._cap);
+		}
+		for (auto &v : o) {
+			insert(v);
+		}
+	}
+
+	// take the storage of o, which uses the same allocator
+	void steal(small_set &o) {
+		if (o._cap == 0) {
+			for (std::size_t i = 0; i < o._n; i++) {
+				::new (in() + i) Vertex(std::move(o.in()[i]));
+				o.in()[i].~Vertex();
+			}
+		} else {
+			_slots = o._slots;
+		}
+		_n = o._n;
+		_cap = o._cap;
+		o._n = o._cap = 0;
+	}
+
+};
+
+#endif // SMALL_SET_H
@@ -0,0 +1,202 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+// optional instrumentation of the hot paths, compiled in with -DGRAPH_STATS
+//
+//   STATS_ADD(counter, k)   add k to a counter
+//   STATS_MAX(counter, x)   raise a counter to at least x
+//   STATS_PHASE("name")     time the enclosing scope as a phase
+//
+// without GRAPH_STATS the counter hooks expand to (void)sizeof(arg), so
+// their arguments are never evaluated. counters are per thread and summed
+// when read, so counting never synchronizes
+class stats {
+public:
+	enum counter {
+		bfs_vertices, bfs_edges,				// bfs_one
+		dfs_vertices, dfs_edges,				// dfs_one
+		heap_pushes, heap_pops, heap_decrease_keys,
+		find_sets, find_set_path, find_set_path_max,
+		relaxations, relaxations_improved,		// Bellman_Ford, Dijkstra
+		augmenting_paths, augmenting_path_edges,
+		io_passes, io_bytes,					// edge_file scans
+		counters
+	};
+
+#ifdef GRAPH_STATS
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	static void add(counter c, std::uint64_t k) {
+		std::atomic<std::uint64_t> &v = local().value[c];
+		v.store(v.load(std::memory_order_relaxed) + k, std::memory_order_relaxed);
+	}
+
+	static void max(counter c, std::uint64_t x) {
+		std::atomic<std::uint64_t> &v = local().value[c];
+		v.store(std::max(v.load(std::memory_order_relaxed), x), std::memory_order_relaxed);
+	}
+
+	// sum (or max) of counter over every thread
+	static std::uint64_t get(counter c) {
+		registry &r = reg();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		std::uint64_t ans = r.retired[c];
+		for (auto *t : r.live) {
+			std::uint64_t v = t->value[c].load(std::memory_order_relaxed);
+			ans = isMax(c) ? std::max(ans, v) : ans + v;
+		}
+		return ans;
+	}
+
+	// zero every counter and phase
+	static void reset() {
+		registry &r = reg();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		std::fill(r.retired, r.retired + counters, 0);
+		for (auto *t : r.live) {
+			for (auto &v : t->value) {
+				v.store(0, std::memory_order_relaxed);
+			}
+		}
+		r.phases.clear();
+	}
+
+	// scope timed as a phase, repeated phases accumulate
+	class phase {
+	public:
+		explicit phase(const char *name) : _name(name), _start(std::chrono::steady_clock::now()) { }
+
+		~phase() {
+			double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+			registry &r = reg();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			r.phases[_name].calls++;
+			r.phases[_name].seconds += s;
+		}
+
+	private:
+		const char *_name;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	// counters and phases as a JSON object
+	static std::string json() {
+		std::ostringstream os;
+		os << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"counters\": {";
+		for (unsigned c = 0; c < counters; c++) {
+			os << (c ? ", " : "") << "\"" << name(counter(c)) << "\": " << get(counter(c));
+		}
+		os << "}, \"phases\": {";
+
+		registry &r = reg();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		bool first(true);
+		for (auto &p : r.phases) {
+			os << (first ? "" : ", ") << "\"" << p.first << "\": {\"calls\": " << p.second.calls
+				<< ", \"seconds\": " << p.second.seconds << "}";
+			first = false;
+		}
+		os << "}}";
+		return os.str();
+	}
+
+	static void dump(std::ostream &os = std::cerr) {
+		os << json() << std::endl;
+	}
+
+private:
+	struct timing {
+		std::uint64_t calls = 0;
+		double seconds = 0.0;
+	};
+
+	struct local_counters;
+
+	struct registry {
+		std::mutex mutex;
+		std::vector<local_counters*> live;
+		std::uint64_t retired[counters] = {0};		// of finished threads
+		std::map<std::string, timing> phases;
+	};
+
+	// counters of one thread, folded into the registry when it exits; only
+	// the owner writes, atomics let json() read them while it runs
+	struct local_counters {
+		std::atomic<std::uint64_t> value[counters];
+
+		local_counters() {
+			for (auto &v : value) {
+				v.store(0, std::memory_order_relaxed);
+			}
+			registry &r = reg();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			r.live.push_back(this);
+		}
+
+		~local_counters() {
+			registry &r = reg();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			for (unsigned c = 0; c < counters; c++) {
+				std::uint64_t v = value[c].load(std::memory_order_relaxed);
+				r.retired[c] = isMax(counter(c)) ? std::max(r.retired[c], v) : r.retired[c] + v;
+			}
+			r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+		}
+	};
+
+	static registry& reg() {
+		static registry *r = new registry();		// outlives thread_local counters
+		return *r;
+	}
+
+	static local_counters& local() {
+		thread_local local_counters t;
+		return t;
+	}
+
+	static bool isMax(counter c) {
+		return c == find_set_path_max;
+	}
+
+	static const char* name(counter c) {
+		static const char *names[counters] = {
+			"bfs_vertices", "bfs_edges", "dfs_vertices", "dfs_edges",
+			"heap_pushes", "heap_pops", "heap_decrease_keys",
+			"find_sets", "find_set_path", "find_set_path_max",
+			"relaxations", "relaxations_improved",
+			"augmenting_paths", "augmenting_path_edges",
+			"io_passes", "io_bytes"
+		};
+		return names[c];
+	}
+
+};
+
+#define STATS_CONCAT2(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT2(a, b)
+
+#ifdef GRAPH_STATS
+#define STATS_ADD(c, k) stats::add(stats::c, (k))
+#define STATS_MAX(c, x) stats::max(stats::c, (x))
+#define STATS_PHASE(name) stats::phase STATS_CONCAT(_stats_phase_, __LINE__)(name)
+#else
+#define STATS_ADD(c, k) ((void)sizeof(k))
+#define STATS_MAX(c, x) ((void)sizeof(x))
+#define STATS_PHASE(name) ((void)0)
+#endif
+
+#endif // STATS_H
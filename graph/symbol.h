@@ -0,0 +1,154 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <unordered_map>
+#include <memory_resource>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#include "arena.h"
+
+// arena backed table mapping each label to a dense id
+// labels and hash nodes are copied once into the arena and never move
+class symbols {
+public:
+	typedef std::uint32_t Id;
+
+	// id used for "no label"
+	static constexpr Id none = std::numeric_limits<Id>::max();
+
+	symbols() { }
+
+	symbols(const symbols &) = delete;
+	symbols& operator = (const symbols &) = delete;
+
+	// process wide table used by symbol
+	static symbols& table() {
+		static symbols S;
+		return S;
+	}
+
+	// number of labels
+	std::size_t size() const {
+		return _label.size();
+	}
+
+	// return true if label has an id
+	bool contains(std::string_view s) const {
+		return (_id.count(s) != 0);
+	}
+
+	// return id of label, adding it if new
+	Id intern(std::string_view s) {
+		auto it = _id.find(s);
+		if (it != _id.end()) {
+			return it->second;
+		}
+
+		assert(size() < none);
+		std::string_view stored = store(s);
+		Id i = _label.size();
+		_label.push_back(stored);
+		_id.emplace(stored, i);
+		return i;
+	}
+
+	// return id of label already in table
+	Id id(std::string_view s) const {
+		assert(contains(s));
+		return _id.find(s)->second;
+	}
+
+	// return label of id
+	std::string_view label(Id i) const {
+		assert(i < size());
+		return _label[i];
+	}
+
+private:
+	arena _arena{1 << 16};
+	std::vector<std::string_view> _label;					// id -> label
+	std::pmr::unordered_map<std::string_view, Id> _id{&_arena};	// label -> id
+
+	// copy label into the arena
+	std::string_view store(std::string_view s) {
+		char *p = static_cast<char*>(_arena.allocate(s.size(), 1));
+		std::memcpy(p, s.data(), s.size());
+		return std::string_view(p, s.size());
+	}
+
+};
+
+// interned label usable as a Vertex, hashing and comparing only its id
+class symbol {
+public:
+	typedef symbols::Id Id;
+
+	// default constructor, not equal to any label
+	symbol() : _id(symbols::none) { }
+
+	symbol(std::string_view s) : _id(symbols::table().intern(s)) { }
+
+	symbol(const std::string &s) : _id(symbols::table().intern(s)) { }
+
+	symbol(const char *s) : _id(symbols::table().intern(s)) { }
+
+	// dense id of label
+	Id id() const {
+		return _id;
+	}
+
+	// label
+	std::string_view str() const {
+		return (_id == symbols::none) ? std::string_view() : symbols::table().label(_id);
+	}
+
+private:
+	Id _id;
+
+};
+
+// compare symbols by id
+inline bool operator == (const symbol &a, const symbol &b) {
+	return a.id() == b.id();
+}
+
+inline bool operator != (const symbol &a, const symbol &b) {
+	return a.id() != b.id();
+}
+
+inline bool operator < (const symbol &a, const symbol &b) {
+	return a.id() < b.id();
+}
+
+// input symbol, interning its label
+inline std::istream& operator >> (std::istream &is, symbol &x) {
+	std::string s;
+	if (is >> s) {
+		x = symbol(s);
+	}
+	return is;
+}
+
+// output label of symbol
+inline std::ostream& operator << (std::ostream &os, const symbol &x) {
+	os << x.str();
+	return os;
+}
+
+namespace std {
+	template <>
+	struct hash<symbol> {
+		std::size_t operator () (const symbol &x) const {
+			return std::hash<symbol::Id>()(x.id());
+		}
+	};
+}
+
+#endif // SYMBOL_H
@@ -0,0 +1,127 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <algorithm>
+
+// fixed set of worker threads running one fork-join job at a time, the
+// calling thread taking part as worker 0; calls to run and parallel_for
+// from several threads are serialised, each waiting for the job before it,
+// so a job must not itself run another on the same pool
+class thread_pool {
+public:
+	thread_pool(std::size_t n = std::thread::hardware_concurrency()) {
+		_n = std::max((std::size_t)1, n);
+		_generation = _pending = 0;
+		_stop = false;
+		for (std::size_t i = 1; i < _n; i++) {
+			_workers.emplace_back(&thread_pool::work, this, i);
+		}
+	}
+
+	thread_pool(const thread_pool &) = delete;
+	thread_pool& operator = (const thread_pool &) = delete;
+
+	~thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_start.notify_all();
+		for (auto &t : _workers) {
+			t.join();
+		}
+	}
+
+	// process wide pool sized to the hardware
+	static thread_pool& shared() {
+		static thread_pool P;
+		return P;
+	}
+
+	// number of workers including the caller
+	std::size_t size() const {
+		return _n;
+	}
+
+	// run f(i) on every worker i and wait for all of them
+	void run(const std::function<void(std::size_t)> &f) {
+		if (_n == 1) {
+			f(0);
+			return;
+		}
+
+		// one job at a time, held until every worker is done with it
+		std::lock_guard<std::mutex> job(_jobs);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_job = &f;
+			_pending = _n - 1;
+			_generation++;
+		}
+		_start.notify_all();
+
+		f(0);
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [this] { return _pending == 0; });
+		_job = nullptr;
+	}
+
+	// run f(lo, hi, i) over chunks of [0, n) claimed dynamically by worker i
+	template <class F>
+	void parallel_for(std::size_t n, std::size_t grain, const F &f) {
+		if (n <= grain || _n == 1) {
+			f(0, n, 0);
+			return;
+		}
+
+		std::atomic<std::size_t> next(0);
+		run([&](std::size_t i) {
+			for (std::size_t lo = next.fetch_add(grain); lo < n; lo = next.fetch_add(grain)) {
+				f(lo, std::min(n, lo + grain), i);
+			}
+		});
+	}
+
+private:
+	std::size_t _n;
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::mutex _jobs;						// held for the whole of a job
+	std::condition_variable _start, _done;
+	const std::function<void(std::size_t)> *_job = nullptr;
+	std::size_t _generation, _pending;
+	bool _stop;
+
+	void work(std::size_t i) {
+		std::size_t seen(0);
+		for (;;) {
+			const std::function<void(std::size_t)> *job;
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_start.wait(lock, [&] { return _stop || _generation != seen; });
+				if (_stop) {
+					return;
+				}
+				seen = _generation;
+				job = _job;
+			}
+
+			(*job)(i);
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (--_pending == 0) {
+				_done.notify_all();
+			}
+		}
+	}
+
+};
+
+#endif // THREAD_POOL_H
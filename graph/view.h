@@ -0,0 +1,125 @@
+#ifndef VIEW_H
+#define VIEW_H
+
+#include <iterator>
+#include <cstddef>
+
+// read only range over the keys of a map, does not copy the map
+template <class Map>
+class key_view {
+public:
+	typedef typename Map::key_type value_type;
+
+	class iterator {
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename Map::key_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const value_type* pointer;
+		typedef const value_type& reference;
+
+		iterator() { }
+
+		explicit iterator(typename Map::const_iterator it) : _it(it) { }
+
+		reference operator * () const {
+			return _it->first;
+		}
+
+		pointer operator -> () const {
+			return &(_it->first);
+		}
+
+		iterator& operator ++ () {
+			++_it;
+			return *this;
+		}
+
+		iterator operator ++ (int) {
+			iterator ans(*this);
+			++_it;
+			return ans;
+		}
+
+		bool operator == (const iterator &o) const {
+			return _it == o._it;
+		}
+
+		bool operator != (const iterator &o) const {
+			return _it != o._it;
+		}
+
+	private:
+		typename Map::const_iterator _it;
+	};
+
+	explicit key_view(const Map &t) : _t(&t) { }
+
+	iterator begin() const {
+		return iterator(_t->begin());
+	}
+
+	iterator end() const {
+		return iterator(_t->end());
+	}
+
+	std::size_t size() const {
+		return _t->size();
+	}
+
+	bool empty() const {
+		return _t->empty();
+	}
+
+	// number of times key is in map, 0 or 1
+	std::size_t count(const value_type &k) const {
+		return _t->count(k);
+	}
+
+private:
+	const Map *_t;
+
+};
+
+// read only range over contiguous elements owned elsewhere
+template <class T>
+class array_view {
+public:
+	typedef T value_type;
+	typedef const T* iterator;
+
+	array_view() : _p(nullptr), _n(0) { }
+
+	array_view(const T *p, std::size_t n) : _p(p), _n(n) { }
+
+	const T* begin() const {
+		return _p;
+	}
+
+	const T* end() const {
+		return _p + _n;
+	}
+
+	const T* data() const {
+		return _p;
+	}
+
+	std::size_t size() const {
+		return _n;
+	}
+
+	bool empty() const {
+		return _n == 0;
+	}
+
+	const T& operator [] (std::size_t i) const {
+		return _p[i];
+	}
+
+private:
+	const T *_p;
+	std::size_t _n;
+
+};
+
+#endif // VIEW_H
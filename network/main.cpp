@@ -2,21 +2,22 @@
 #include <fstream>
 #include <cassert>
 
+#include "../graph/symbol.h"
 #include "network.h"
 
 using namespace std;
 
 int main() {
-	network<string> N;
+	network<symbol> N;
 	cin >> N;
 	cout << N << endl;
 
-	network<string> apsp = N.Floyd_Warshall();
+	network<symbol> apsp = N.Floyd_Warshall();
 	cout << apsp << endl;
 
-	network<string> sssp1 = N.Bellman_Ford("0");
+	network<symbol> sssp1 = N.Bellman_Ford("0");
 	cout << sssp1 << endl;
 	
-	network<string> sssp2 = N.Dijkstra("0");
+	network<symbol> sssp2 = N.Dijkstra("0");
 	cout << sssp2 << endl;
 }
\ No newline at end of file
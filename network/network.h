@@ -4,6 +4,7 @@
 #include "../digraph/digraph.h"
 #include "../digraph/dfs.h"
 #include "../digraph/tscc.h"
+#include "../graph/csr.h"
 #include "../wgraph/wedge.h"
 #include "../wgraph/dary_heap.h"
 
@@ -11,6 +12,9 @@
 #include <map>
 #include <unordered_map>
 #include <set>
+#include <queue>
+#include <vector>
+#include <functional>
 #include <limits>
 
 template <class Vertex>
@@ -19,6 +23,9 @@ public:
 
 	network() { }
 
+	// adjacency and costs allocated from r, which must outlive the network
+	explicit network(std::pmr::memory_resource *r) : digraph<Vertex>(r), _c(r) { }
+
 	// add edge if not already in graph
 	void addEdge(const Vertex &v, const Vertex &w, double c) {
 		digraph<Vertex>::addEdge(v, w);
@@ -62,6 +69,7 @@ public:
 
 	// return the shortest distances from start vertex using Bellman Ford's Algorithm
 	network<Vertex> Bellman_Ford(const Vertex &s) const {
+		STATS_PHASE("Bellman_Ford");
 		network<Vertex> ans;
 		std::unordered_map<Vertex, double> d, D;    // old and new distances from s
 		std::unordered_map<Vertex, Vertex> parent;  // parent
@@ -76,7 +84,9 @@ public:
 			D = d;
 			for (auto &e : E()) {
 				double temp = d[e.v] + e.c;
+				STATS_ADD(relaxations, 1);
 				if (temp < D[e.w]) {
+					STATS_ADD(relaxations_improved, 1);
 					D[e.w] = temp;
 					parent[e.w] = e.v;
 					if (i == digraph<Vertex>::n()) {
@@ -102,6 +112,7 @@ public:
 
 	// return the shortest distances from start vertex using Dijkstra's Algorithm
 	network<Vertex> Dijkstra(const Vertex &s) const {
+		STATS_PHASE("Dijkstra");
 		network<Vertex> ans;
 		std::unordered_map<Vertex, double> d;		// distances from s
 		std::unordered_map<Vertex, Vertex> parent;	// parent
@@ -127,7 +138,9 @@ public:
 			}
 			for (auto &y : digraph<Vertex>::Adj(x.w)) {
 				double temp = d[x.w] + cost(x.w, y);
+				STATS_ADD(relaxations, 1);
 				if (temp < d[y]) {
+					STATS_ADD(relaxations_improved, 1);
 					H.decrease_key(WEdge<Vertex>(parent.at(y), y, d[y]), WEdge<Vertex>(x.w, y, temp));
 					d[y] = temp;
 					parent[y] = x.w;
@@ -140,6 +153,7 @@ public:
 
 	// return the shortest distances between all vertices using Floyd Warshall's Algorithm
 	network<Vertex> Floyd_Warshall() const {
+		STATS_PHASE("Floyd_Warshall");
 		network<Vertex> ans;
 
 		for (auto &v : digraph<Vertex>::V()) {
@@ -171,9 +185,64 @@ public:
 
 private:
 	// cost "red-black tree" representation
-	std::map<Edge<Vertex>, double> _c; 
+	std::pmr::map<Edge<Vertex>, double> _c; 
 };
 
+// shortest path tree from s on a csr snapshot, cost[a] is the cost of arc a
+// of targets() (see arc_costs); distances and parents are dense arrays and
+// the heap holds (distance, id) pairs, skipping those already improved on
+template <class Vertex>
+network<Vertex> Dijkstra(const csr<Vertex> &S, const std::vector<double> &cost, const Vertex &s) {
+	STATS_PHASE("Dijkstra/csr");
+	typedef typename csr<Vertex>::Id Id;
+	typedef std::pair<double, Id> Entry;
+	assert(cost.size() == S.arcs() && S.isVertex(s));
+
+	array_view<std::size_t> off = S.offsets();
+	array_view<Id> adj = S.targets();
+	std::vector<double> d(S.n(), std::numeric_limits<double>::infinity());
+	std::vector<Id> parent(S.n(), csr<Vertex>::none);
+	std::vector<std::size_t> via(S.n());				// arc from parent
+	std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > H;
+
+	d[S.id(s)] = 0.0;
+	H.push(Entry(0.0, S.id(s)));
+	STATS_ADD(heap_pushes, 1);
+	while (!H.empty()) {
+		Entry x = H.top();
+		H.pop();
+		STATS_ADD(heap_pops, 1);
+		if (x.first > d[x.second]) {
+			continue;
+		}
+
+		for (std::size_t a = off[x.second]; a < off[x.second+1]; a++) {
+			Id y = adj[a];
+			double temp = x.first + cost[a];
+			STATS_ADD(relaxations, 1);
+			if (temp < d[y]) {
+				STATS_ADD(relaxations_improved, 1);
+				STATS_ADD(heap_pushes, 1);
+				d[y] = temp;
+				parent[y] = x.second;
+				via[y] = a;
+				H.push(Entry(temp, y));
+			}
+		}
+	}
+
+	network<Vertex> ans;
+	for (Id v = 0; v < S.n(); v++) {
+		ans.addVertex(S.vertex(v));
+	}
+	for (Id v = 0; v < S.n(); v++) {
+		if (parent[v] != csr<Vertex>::none) {
+			ans.addEdge(S.vertex(parent[v]), S.vertex(v), cost[via[v]]);
+		}
+	}
+	return ans;
+}
+
 
 // input network
 template <class Vertex>
@@ -5,6 +5,8 @@
 #include <map>
 #include <cassert>
 
+#include "../graph/stats.h"
+
 
 template <class T>
 class dary_heap {
@@ -29,6 +31,7 @@ public:
 
 	void push(const T &x) {
 		assert(_l.count(x) == 0);
+		STATS_ADD(heap_pushes, 1);
 
 		if (_n == _data.size()) {
 			_data.push_back(x);
@@ -55,6 +58,7 @@ public:
 
 	void decrease_key(const T &x, const T &newX) {
 		assert(newX < x && _l.count(x) != 0 && _l.count(newX) == 0);
+		STATS_ADD(heap_decrease_keys, 1);
 
 		std::size_t i = _l[x];
 		_data[i] = newX;
@@ -72,6 +76,7 @@ public:
 
 	void pop_min() {
 		assert(!empty());
+		STATS_ADD(heap_pops, 1);
 
 		_l.erase(_data[0]);
 		_n--;
@@ -2,6 +2,9 @@
 #define DS_H
 
 #include <unordered_map>
+#include <cassert>
+
+#include "../graph/stats.h"
 
 template <class T>
 struct node {
@@ -38,12 +41,25 @@ public:
 		return pr->key;
 	}
 
+	// root of the set of x, every node on the path is linked to the root
 	node<T>* find_set(const T &x) {
 		assert(_data.count(x) != 0);
-		if (_data[x] == _data[x]->parent) {
-			return _data[x];
+		node<T> *first = _data[x], *root = first;
+		std::size_t path(0);
+		while (root != root->parent) {
+			root = root->parent;
+			path++;
+		}
+		STATS_ADD(find_sets, 1);
+		STATS_ADD(find_set_path, path);
+		STATS_MAX(find_set_path_max, path);
+
+		while (first != root) {
+			node<T> *next = first->parent;
+			first->parent = root;
+			first = next;
 		}
-		return (_data[x]->parent = find_set(_data[x]->parent->key));
+		return root;
 	}
 
 	bool join_sets(const T &x, const T &y) {
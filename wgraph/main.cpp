@@ -2,6 +2,7 @@
 #include <fstream>
 #include <cassert>
 
+#include "../graph/symbol.h"
 #include "wedge.h"
 #include "wgraph.h"
 #include "ds.h"
@@ -10,16 +11,16 @@
 using namespace std;
 
 int main() {
-	wgraph<string> W;
+	wgraph<symbol> W;
 	cin >> W;
 	cout << W << endl;
 
-	wgraph<string> m = W.Kruskal_MST();
+	wgraph<symbol> m = W.Kruskal_MST();
 	cout << m << endl;
 
-	wgraph<string> n = W.Boruvka_MST();
+	wgraph<symbol> n = W.Boruvka_MST();
 	cout << n << endl;
 
-	wgraph<string> o = W.Prim_MST();
+	wgraph<symbol> o = W.Prim_MST();
 	cout << o << endl;
 }
@@ -5,6 +5,7 @@
 #include "../graph/bfs.h"
 #include "../graph/dfs.h"
 #include "../graph/eulerian.h"
+#include "../graph/pcc.h"
 #include "wedge.h"
 #include "ds.h"
 #include "dary_heap.h"
@@ -22,6 +23,9 @@ public:
 	// default constructor
 	wgraph() { }
 
+	// adjacency and costs allocated from r, which must outlive the graph
+	explicit wgraph(std::pmr::memory_resource *r) : graph<Vertex>(r), _c(r) { }
+
 	// return true and add edge if not already in graph
 	bool addEdge(const Vertex &v, const Vertex &w, double c) {
 		if (!graph<Vertex>::isVertex(v) || !graph<Vertex>::isVertex(w)) { return false; }
@@ -76,6 +80,7 @@ public:
 
 	// return the minimum spanning wgraph using Kruskal's MST Algorithm
 	wgraph<Vertex> Kruskal_MST() const {
+		STATS_PHASE("Kruskal_MST");
 		assert(graph<Vertex>::isConnected());
 		wgraph<Vertex> ans;
 
@@ -97,6 +102,7 @@ public:
 
 	// return the minimum spanning wgraph using Boruvka's MST Algorithm
 	wgraph<Vertex> Boruvka_MST() const {
+		STATS_PHASE("Boruvka_MST");
 		assert(graph<Vertex>::isConnected());
 		wgraph<Vertex> ans;
 
@@ -135,14 +141,16 @@ public:
 
 	// return the minimum spanning wgraph using Prim's MST Algorithm
 	wgraph<Vertex> Prim_MST() const {
+		STATS_PHASE("Prim_MST");
 		std::unordered_map<Vertex, double> d;
-		Vertex s;
+		Vertex s = Vertex();
 		dary_heap< WEdge<Vertex> > H = dary_heap< WEdge<Vertex> >(std::max((size_t)2, (graph<Vertex>::m()/graph<Vertex>::n())));
 		for (auto &v : graph<Vertex>::V()) {
-			d[v] = std::numeric_limits<double>::infinity();
 			if (d.size() == 0) {
 				d[v] = 0;
 				s = v;
+			} else {
+				d[v] = std::numeric_limits<double>::infinity();
 			}
 		}
 
@@ -175,7 +183,7 @@ public:
 
 private:
 	// cost "red-black tree" representation
-	std::map<Edge<Vertex>, double> _c;
+	std::pmr::map<Edge<Vertex>, double> _c;
 };
 
 // input wgraph